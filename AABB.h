@@ -0,0 +1,108 @@
+#pragma once
+#include "Math.h"
+
+// Segment start + t * (end - start) for box tests, with the reciprocal direction
+// precomputed so each slab test is just multiplies and min/max
+struct AABBRay
+{
+	AABBRay(const Vector3& start, const Vector3& end, float fuzz = 0.0f)
+	: mStart(start)
+	, mFuzz(fuzz)
+	{
+		// Zero components become a huge (but finite) reciprocal so we never get 0 * inf
+		constexpr float MIN_DIR = 1e-12f;
+		Vector3 dir = end - start;
+		mInvDir.x = 1.0f / (Math::Abs(dir.x) > MIN_DIR ? dir.x : MIN_DIR);
+		mInvDir.y = 1.0f / (Math::Abs(dir.y) > MIN_DIR ? dir.y : MIN_DIR);
+		mInvDir.z = 1.0f / (Math::Abs(dir.z) > MIN_DIR ? dir.z : MIN_DIR);
+	}
+
+	Vector3 mStart;
+	Vector3 mInvDir;
+	// Boxes are grown by this much before testing
+	float mFuzz;
+};
+
+// World-space axis-aligned bounding box
+struct AABB
+{
+	AABB() = default;
+	AABB(const Vector3& min, const Vector3& max)
+	: mMin(min)
+	, mMax(max)
+	{
+	}
+
+	// Returns true if the boxes overlap (touching counts, same as CollisionComponent)
+	bool Intersects(const AABB& other) const
+	{
+		bool noIntersection = mMax.x < other.mMin.x || mMax.y < other.mMin.y ||
+							  mMax.z < other.mMin.z || other.mMax.x < mMin.x ||
+							  other.mMax.y < mMin.y || other.mMax.z < mMin.z;
+		return !noIntersection;
+	}
+
+	// Slab test against the ray for t in [0, maxT]. On a hit, outEntryT is where the
+	// ray enters the box (0 if it starts inside).
+	bool RayIntersects(const AABBRay& ray, float maxT, float& outEntryT) const
+	{
+		Vector3 lo = (mMin - Vector3(ray.mFuzz) - ray.mStart) * ray.mInvDir;
+		Vector3 hi = (mMax + Vector3(ray.mFuzz) - ray.mStart) * ray.mInvDir;
+
+		float tNear = Math::Max(Math::Max(Math::Min(lo.x, hi.x), Math::Min(lo.y, hi.y)),
+								Math::Max(Math::Min(lo.z, hi.z), 0.0f));
+		float tFar = Math::Min(Math::Min(Math::Max(lo.x, hi.x), Math::Max(lo.y, hi.y)),
+							   Math::Min(Math::Max(lo.z, hi.z), maxT));
+
+		outEntryT = tNear;
+		return tNear <= tFar;
+	}
+
+	// Returns true if other is completely inside this box
+	bool Contains(const AABB& other) const
+	{
+		return mMin.x <= other.mMin.x && mMin.y <= other.mMin.y && mMin.z <= other.mMin.z &&
+			   other.mMax.x <= mMax.x && other.mMax.y <= mMax.y && other.mMax.z <= mMax.z;
+	}
+
+	// Grow the box by amount on every side
+	void Expand(float amount)
+	{
+		mMin -= Vector3(amount);
+		mMax += Vector3(amount);
+	}
+
+	// Grow the box so it also covers point
+	void AddPoint(const Vector3& point)
+	{
+		mMin.x = Math::Min(mMin.x, point.x);
+		mMin.y = Math::Min(mMin.y, point.y);
+		mMin.z = Math::Min(mMin.z, point.z);
+		mMax.x = Math::Max(mMax.x, point.x);
+		mMax.y = Math::Max(mMax.y, point.y);
+		mMax.z = Math::Max(mMax.z, point.z);
+	}
+
+	Vector3 GetCenter() const { return (mMin + mMax) * 0.5f; }
+
+	// Surface area, used as the cost metric when building/inserting into trees
+	float SurfaceArea() const
+	{
+		Vector3 d = mMax - mMin;
+		return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+	}
+
+	static AABB Union(const AABB& a, const AABB& b)
+	{
+		AABB retVal = a;
+		retVal.AddPoint(b.mMin);
+		retVal.AddPoint(b.mMax);
+		return retVal;
+	}
+
+	// Empty box that any AddPoint/Union will replace
+	static AABB Empty() { return {Vector3::Infinity, Vector3::NegInfinity}; }
+
+	Vector3 mMin;
+	Vector3 mMax;
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include "AABB.h"
+#include "Simd.h"
+
+// Up to MAX_LANES segments tested against boxes together, four lanes per SIMD op.
+// Same math as AABBRay/AABB::RayIntersects, laid out as structure of arrays.
+struct AABBRayPacket
+{
+	static constexpr int MAX_LANES = 16;
+
+	// Start a new packet with numLanes lanes (rounded up to groups of 4, the
+	// padding lanes never hit anything)
+	void Reset(int numLanes, float fuzz)
+	{
+		mNumGroups = (numLanes + 3) / 4;
+		mFuzz = fuzz;
+		mAverageDir = Vector3::Zero;
+		for (int i = 0; i < MAX_LANES; i++)
+		{
+			mStartX[i] = mStartY[i] = mStartZ[i] = 0.0f;
+			mInvDirX[i] = mInvDirY[i] = mInvDirZ[i] = 1.0f;
+			// Negative max t means the lane is inactive
+			mMaxT[i] = -1.0f;
+		}
+	}
+
+	void SetLane(int lane, const Vector3& start, const Vector3& end, float maxT)
+	{
+		AABBRay ray(start, end);
+		mStartX[lane] = start.x;
+		mStartY[lane] = start.y;
+		mStartZ[lane] = start.z;
+		mInvDirX[lane] = ray.mInvDir.x;
+		mInvDirY[lane] = ray.mInvDir.y;
+		mInvDirZ[lane] = ray.mInvDir.z;
+		mMaxT[lane] = maxT;
+		mAverageDir += end - start;
+	}
+
+	// Returns a bitmask of the lanes that hit box within their current max t
+	unsigned int Intersect(const AABB& box) const
+	{
+		using namespace Simd;
+		const Float4 MIN_X = Set1(box.mMin.x - mFuzz);
+		const Float4 MIN_Y = Set1(box.mMin.y - mFuzz);
+		const Float4 MIN_Z = Set1(box.mMin.z - mFuzz);
+		const Float4 MAX_X = Set1(box.mMax.x + mFuzz);
+		const Float4 MAX_Y = Set1(box.mMax.y + mFuzz);
+		const Float4 MAX_Z = Set1(box.mMax.z + mFuzz);
+		const Float4 ZERO = Set1(0.0f);
+
+		unsigned int mask = 0;
+		for (int g = 0; g < mNumGroups; g++)
+		{
+			const int BASE = g * 4;
+			Float4 startX = Load(mStartX + BASE);
+			Float4 startY = Load(mStartY + BASE);
+			Float4 startZ = Load(mStartZ + BASE);
+			Float4 invX = Load(mInvDirX + BASE);
+			Float4 invY = Load(mInvDirY + BASE);
+			Float4 invZ = Load(mInvDirZ + BASE);
+
+			Float4 loX = Mul(Sub(MIN_X, startX), invX);
+			Float4 hiX = Mul(Sub(MAX_X, startX), invX);
+			Float4 loY = Mul(Sub(MIN_Y, startY), invY);
+			Float4 hiY = Mul(Sub(MAX_Y, startY), invY);
+			Float4 loZ = Mul(Sub(MIN_Z, startZ), invZ);
+			Float4 hiZ = Mul(Sub(MAX_Z, startZ), invZ);
+
+			Float4 tNear = Max(Max(Min(loX, hiX), Min(loY, hiY)), Max(Min(loZ, hiZ), ZERO));
+			Float4 tFar = Min(Min(Max(loX, hiX), Max(loY, hiY)),
+							  Min(Max(loZ, hiZ), Load(mMaxT + BASE)));
+
+			mask |= static_cast<unsigned int>(LessEqualMask(tNear, tFar)) << BASE;
+		}
+		return mask;
+	}
+
+	alignas(16) float mStartX[MAX_LANES];
+	alignas(16) float mStartY[MAX_LANES];
+	alignas(16) float mStartZ[MAX_LANES];
+	alignas(16) float mInvDirX[MAX_LANES];
+	alignas(16) float mInvDirY[MAX_LANES];
+	alignas(16) float mInvDirZ[MAX_LANES];
+	// Per lane, only hits at or before this t matter (shrinks as hits are found)
+	alignas(16) float mMaxT[MAX_LANES];
+
+	// Sum of lane directions, used to pick which child to visit first
+	Vector3 mAverageDir;
+	float mFuzz = 0.0f;
+	int mNumGroups = 0;
+};
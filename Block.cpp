@@ -15,11 +15,12 @@ Block::Block()
 
 	mMesh = CreateComponent<MeshComponent>();
 	mMesh->SetMesh(gGame.GetRenderer()->GetMesh("Assets/Meshes/Cube.gpmesh"));
+	// LevelLoader bakes it into the static geometry (or instances it)
 
 	mColl = CreateComponent<CollisionComponent>();
 	mColl->SetSize({1.0f, 1.0f, 1.0f});
 
-	gGame.AddCollider(this);
+	gGame.AddCollider(this, true);
 }
 
 Block::~Block()
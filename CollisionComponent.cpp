@@ -1,56 +1,115 @@
 #include "CollisionComponent.h"
 #include "Actor.h"
 #include "Math.h"
+#include "Game.h"
+#include "CollisionWorld.h"
 
 namespace
 {
 	// Scale factor for half-extents of the collision box
 	constexpr float HALF_EXTENT_SCALE = 0.5f;
+
+	constexpr CollisionResponse I = CollisionResponse::Ignore;
+	constexpr CollisionResponse O = CollisionResponse::Overlap;
+	constexpr CollisionResponse B = CollisionResponse::Block;
+
+	// Rows and columns in CollisionLayer order
+	constexpr CollisionResponse RESPONSE_TABLE[NUM_COLLISION_LAYERS][NUM_COLLISION_LAYERS] = {
+		//		 World Player Pellet Portal Trigger Turret Glass Energy
+		/* World   */ {I, B, B, I, I, B, I, B},
+		/* Player  */ {B, I, O, O, O, B, B, B},
+		/* Pellet  */ {B, O, I, O, I, B, B, O},
+		/* Portal  */ {I, O, O, I, I, O, I, O},
+		/* Trigger */ {I, O, I, I, I, I, I, I},
+		/* Turret  */ {B, B, B, O, I, B, B, B},
+		/* Glass   */ {I, B, B, I, I, B, I, B},
+		/* Energy  */ {B, B, O, O, I, B, B, B},
+	};
 } // namespace
 
+CollisionResponse GetCollisionResponse(CollisionLayer a, CollisionLayer b)
+{
+	return RESPONSE_TABLE[static_cast<int>(a)][static_cast<int>(b)];
+}
+
+unsigned int GetDefaultCollisionMask(CollisionLayer layer)
+{
+	unsigned int mask = 0;
+	for (int i = 0; i < NUM_COLLISION_LAYERS; i++)
+	{
+		if (RESPONSE_TABLE[static_cast<int>(layer)][i] != CollisionResponse::Ignore)
+		{
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+}
+
 CollisionComponent::CollisionComponent(class Actor* owner)
 : Component(owner)
 {
+	// Everything with a collision box can be hit by segment casts
+	gGame.GetCollisionWorld()->RegisterComponent(this);
 }
 
-bool CollisionComponent::Intersect(const CollisionComponent* other) const
+CollisionComponent::~CollisionComponent()
+{
+	gGame.GetCollisionWorld()->UnregisterComponent(this);
+}
+
+void CollisionComponent::SetLayer(CollisionLayer layer)
 {
-	Vector3 thisMin = GetMin();
-	Vector3 thisMax = GetMax();
-	Vector3 otherMin = other->GetMin();
-	Vector3 otherMax = other->GetMax();
+	mLayer = layer;
+	mMask = GetDefaultCollisionMask(layer);
+	gGame.GetCollisionWorld()->UpdateFilter(this);
+}
 
-	bool noIntersection = thisMax.x < otherMin.x || thisMax.y < otherMin.y ||
-						  thisMax.z < otherMin.z || otherMax.x < thisMin.x ||
-						  otherMax.y < thisMin.y || otherMax.z < thisMin.z;
+void CollisionComponent::SetMask(unsigned int mask)
+{
+	mMask = mask;
+	gGame.GetCollisionWorld()->UpdateFilter(this);
+}
 
-	return !noIntersection;
+void CollisionComponent::SetOnTriggerEnter(const std::function<void(CollisionComponent*)>& onEnter)
+{
+	mOnTriggerEnter = onEnter;
+	gGame.GetCollisionWorld()->AddTrigger(this);
 }
 
-Vector3 CollisionComponent::GetMin() const
+void CollisionComponent::SetOnTriggerStay(const std::function<void(CollisionComponent*)>& onStay)
 {
-	Vector3 v = GetCenter();
-	Vector3 scale = mOwner->GetTransform().GetScale();
+	mOnTriggerStay = onStay;
+	gGame.GetCollisionWorld()->AddTrigger(this);
+}
 
-	// Subtract half-extents in each axis
-	v.x -= mSize.x * scale.x * HALF_EXTENT_SCALE;
-	v.y -= mSize.y * scale.y * HALF_EXTENT_SCALE;
-	v.z -= mSize.z * scale.z * HALF_EXTENT_SCALE;
+void CollisionComponent::SetOnTriggerExit(const std::function<void(CollisionComponent*)>& onExit)
+{
+	mOnTriggerExit = onExit;
+	gGame.GetCollisionWorld()->AddTrigger(this);
+}
 
-	return v;
+bool CollisionComponent::Intersect(const CollisionComponent* other) const
+{
+	return GetAABB().Intersects(other->GetAABB());
 }
 
-Vector3 CollisionComponent::GetMax() const
+const AABB& CollisionComponent::GetAABB() const
 {
-	Vector3 v = GetCenter();
-	Vector3 scale = mOwner->GetTransform().GetScale();
+	const unsigned int VERSION = mOwner->GetTransform().GetVersion();
+	if (mIsBoxDirty || VERSION != mBoxVersion)
+	{
+		mIsBoxDirty = false;
+		mBoxVersion = VERSION;
+		mBoxRevision++;
 
-	// Add half-extents in each axis
-	v.x += mSize.x * scale.x * HALF_EXTENT_SCALE;
-	v.y += mSize.y * scale.y * HALF_EXTENT_SCALE;
-	v.z += mSize.z * scale.z * HALF_EXTENT_SCALE;
+		Vector3 center = GetCenter();
 
-	return v;
+		// Subtract/add half-extents in each axis
+		Vector3 halfExtents = GetHalfExtents();
+		mWorldBox.mMin = center - halfExtents;
+		mWorldBox.mMax = center + halfExtents;
+	}
+	return mWorldBox;
 }
 
 Vector3 CollisionComponent::GetCenter() const
@@ -58,6 +117,13 @@ Vector3 CollisionComponent::GetCenter() const
 	return mOwner->GetTransform().GetPosition();
 }
 
+Vector3 CollisionComponent::GetHalfExtents() const
+{
+	const Vector3& scale = mOwner->GetTransform().GetScale();
+	return Vector3(mSize.x * scale.x * HALF_EXTENT_SCALE, mSize.y * scale.y * HALF_EXTENT_SCALE,
+				   mSize.z * scale.z * HALF_EXTENT_SCALE);
+}
+
 CollSide CollisionComponent::GetMinOverlap(const CollisionComponent* other, Vector3& offset) const
 {
 	offset = Vector3::Zero;
@@ -1,6 +1,8 @@
 #pragma once
 #include "Component.h"
 #include "Math.h"
+#include "AABB.h"
+#include <functional>
 
 enum class CollSide
 {
@@ -13,25 +15,124 @@ enum class CollSide
 	Back
 };
 
+// What kind of thing a collision box belongs to
+enum class CollisionLayer
+{
+	World,
+	Player,
+	Pellet,
+	Portal,
+	Trigger,
+	Turret,
+	Glass,
+	// Energy cubes and catchers (block movement, but pellets go into them)
+	Energy
+};
+
+constexpr int NUM_COLLISION_LAYERS = 8;
+constexpr unsigned int ALL_COLLISION_LAYERS = (1u << NUM_COLLISION_LAYERS) - 1;
+
+constexpr unsigned int GetLayerBit(CollisionLayer layer)
+{
+	return 1u << static_cast<unsigned int>(layer);
+}
+
+// How two layers interact
+enum class CollisionResponse
+{
+	Ignore,
+	Overlap,
+	Block
+};
+
+// Looks up the response table (the same both ways around)
+CollisionResponse GetCollisionResponse(CollisionLayer a, CollisionLayer b);
+// Every layer that layer doesn't ignore
+unsigned int GetDefaultCollisionMask(CollisionLayer layer);
+
 class CollisionComponent : public Component
 {
 protected:
 	CollisionComponent(class Actor* owner);
+	~CollisionComponent() override;
 	friend class Actor;
 
 public:
 	// Set width/height of this box
-	void SetSize(const Vector3& size) { mSize = size; }
+	void SetSize(const Vector3& size)
+	{
+		mSize = size;
+		mIsBoxDirty = true;
+	}
+
+	// Layer defaults to World. Setting it also resets the mask to every layer
+	// the response table doesn't ignore.
+	void SetLayer(CollisionLayer layer);
+	CollisionLayer GetLayer() const { return mLayer; }
+	// Layers this box can interact with (both boxes' masks have to agree)
+	void SetMask(unsigned int mask);
+	unsigned int GetMask() const { return mMask; }
+	bool CanCollideWith(const CollisionComponent* other) const
+	{
+		return (mMask & GetLayerBit(other->mLayer)) != 0 &&
+			   (other->mMask & GetLayerBit(mLayer)) != 0;
+	}
+
+	// Called for things that overlap this box instead of being blocked by it
+	void SetOnOverlap(const std::function<void(CollisionComponent*)>& onOverlap)
+	{
+		mOnOverlap = onOverlap;
+	}
+	void NotifyOverlap(CollisionComponent* other) const
+	{
+		if (mOnOverlap)
+		{
+			mOnOverlap(other);
+		}
+	}
+
+	// Trigger volume events, sent once per frame by CollisionWorld::UpdateTriggers
+	// for everything this box overlaps (setting any of them makes it a trigger)
+	void SetOnTriggerEnter(const std::function<void(CollisionComponent*)>& onEnter);
+	void SetOnTriggerStay(const std::function<void(CollisionComponent*)>& onStay);
+	void SetOnTriggerExit(const std::function<void(CollisionComponent*)>& onExit);
+	void NotifyTriggerEnter(CollisionComponent* other) const
+	{
+		if (mOnTriggerEnter)
+		{
+			mOnTriggerEnter(other);
+		}
+	}
+	void NotifyTriggerStay(CollisionComponent* other) const
+	{
+		if (mOnTriggerStay)
+		{
+			mOnTriggerStay(other);
+		}
+	}
+	void NotifyTriggerExit(CollisionComponent* other) const
+	{
+		if (mOnTriggerExit)
+		{
+			mOnTriggerExit(other);
+		}
+	}
 
 	// Returns true if this box intersects with other
 	bool Intersect(const CollisionComponent* other) const;
 
 	// Get min and max points of box
-	Vector3 GetMin() const;
-	Vector3 GetMax() const;
+	const Vector3& GetMin() const { return GetAABB().mMin; }
+	const Vector3& GetMax() const { return GetAABB().mMax; }
+	// Get min and max points as a box (cached until the owner's transform changes)
+	const AABB& GetAABB() const;
+	// Changes every time the cached box is recomputed
+	unsigned int GetBoxRevision() const { return mBoxRevision; }
 
 	// Get width, height, center of box
 	Vector3 GetCenter() const;
+	// Half the size of the box, including the owner's scale
+	Vector3 GetHalfExtents() const;
 	const Vector3& GetSize() const { return mSize; }
 
 	// Returns side of minimum overlap against other
@@ -42,4 +143,21 @@ public:
 
 private:
 	Vector3 mSize;
+
+	CollisionLayer mLayer = CollisionLayer::World;
+	unsigned int mMask = GetDefaultCollisionMask(CollisionLayer::World);
+	std::function<void(CollisionComponent*)> mOnOverlap;
+	std::function<void(CollisionComponent*)> mOnTriggerEnter;
+	std::function<void(CollisionComponent*)> mOnTriggerStay;
+	std::function<void(CollisionComponent*)> mOnTriggerExit;
+
+	// Cached world box, and the transform version it was built from
+	mutable AABB mWorldBox;
+	mutable unsigned int mBoxVersion = 0;
+	mutable unsigned int mBoxRevision = 0;
+	mutable bool mIsBoxDirty = true;
+
+	// Handle in the collision world, or -1 if not registered
+	int mProxyId = -1;
+	friend class CollisionWorld;
 };
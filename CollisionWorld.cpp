@@ -0,0 +1,868 @@
+#include "CollisionWorld.h"
+#include <algorithm>
+#include "CollisionComponent.h"
+#include "SegmentCast.h"
+#include "Actor.h"
+#include "Simd.h"
+
+namespace
+{
+	// SegmentCast treats points up to 0.01 outside a box as inside, so grow boxes
+	// a bit past that for the slab tests to never miss a hit
+	constexpr float SEGMENT_CAST_FUZZ = 0.02f;
+} // namespace
+
+void CollisionWorld::RegisterComponent(CollisionComponent* coll)
+{
+	if (!coll || coll->mProxyId != -1)
+	{
+		return;
+	}
+
+	int proxyId = 0;
+	if (!mFreeProxies.empty())
+	{
+		proxyId = mFreeProxies.back();
+		mFreeProxies.pop_back();
+	}
+	else
+	{
+		proxyId = static_cast<int>(mProxies.size());
+		mProxies.emplace_back();
+		mBoxes.Resize(mProxies.size());
+	}
+
+	Proxy& proxy = mProxies[proxyId];
+	proxy.mColl = coll;
+	proxy.mSequence = mNextSequence++;
+	proxy.mLayerBit = GetLayerBit(coll->GetLayer());
+	proxy.mMask = coll->GetMask();
+
+	const AABB& box = coll->GetAABB();
+	proxy.mBoxRevision = coll->GetBoxRevision();
+	mBoxes.Set(proxyId, box);
+
+	// Everything starts in the dynamic tree. Static colliders are usually created
+	// before they're positioned, so they only move to the BVH in BuildStaticTree.
+	proxy.mTreeId = mDynamicTree.CreateProxy(box, proxyId);
+	mDynamicProxies.emplace_back(proxyId);
+
+	coll->mProxyId = proxyId;
+}
+
+void CollisionWorld::UnregisterComponent(CollisionComponent* coll)
+{
+	if (!coll || coll->mProxyId == -1)
+	{
+		return;
+	}
+
+	RemoveCollider(coll);
+	RemoveTrigger(coll);
+
+	// Anything it was inside of just loses it, without an exit event
+	std::erase_if(mTriggerPairs, [coll](const TriggerPair& pair) {
+		return pair.mOther == coll;
+	});
+
+	const int PROXY_ID = coll->mProxyId;
+	Proxy& proxy = mProxies[PROXY_ID];
+	if (proxy.mTreeId != -1)
+	{
+		mDynamicTree.DestroyProxy(proxy.mTreeId);
+		auto iter = std::ranges::find(mDynamicProxies, PROXY_ID);
+		*iter = mDynamicProxies.back();
+		mDynamicProxies.pop_back();
+	}
+
+	if (proxy.mStaticIndex != -1)
+	{
+		// The BVH is immutable, so just orphan the entry until the next build
+		mStaticProxies[proxy.mStaticIndex] = -1;
+	}
+
+	proxy = Proxy();
+	mFreeProxies.emplace_back(PROXY_ID);
+	coll->mProxyId = -1;
+}
+
+void CollisionWorld::UpdateFilter(CollisionComponent* coll)
+{
+	if (!coll || coll->mProxyId == -1)
+	{
+		return;
+	}
+
+	Proxy& proxy = mProxies[coll->mProxyId];
+	proxy.mLayerBit = GetLayerBit(coll->GetLayer());
+	proxy.mMask = coll->GetMask();
+	mColliderRevision++;
+}
+
+void CollisionWorld::AddCollider(CollisionComponent* coll, bool isStatic)
+{
+	if (!coll)
+	{
+		return;
+	}
+
+	RegisterComponent(coll);
+	Proxy& proxy = mProxies[coll->mProxyId];
+	if (proxy.mIsCollider)
+	{
+		return;
+	}
+
+	proxy.mIsCollider = true;
+	proxy.mIsStatic = isStatic;
+	proxy.mColliderSequence = mNextColliderSequence++;
+	mNumColliders++;
+	mColliderRevision++;
+}
+
+void CollisionWorld::RemoveCollider(CollisionComponent* coll)
+{
+	if (!coll || coll->mProxyId == -1)
+	{
+		return;
+	}
+
+	// Static colliders stay in the BVH, queries skip non-colliders
+	Proxy& proxy = mProxies[coll->mProxyId];
+	if (proxy.mIsCollider)
+	{
+		proxy.mIsCollider = false;
+		mNumColliders--;
+		mColliderRevision++;
+	}
+}
+
+void CollisionWorld::AddTrigger(CollisionComponent* trigger)
+{
+	if (!trigger)
+	{
+		return;
+	}
+
+	RegisterComponent(trigger);
+	Proxy& proxy = mProxies[trigger->mProxyId];
+	if (!proxy.mIsTrigger)
+	{
+		proxy.mIsTrigger = true;
+		mTriggerProxies.emplace_back(trigger->mProxyId);
+	}
+}
+
+void CollisionWorld::RemoveTrigger(CollisionComponent* trigger)
+{
+	if (!trigger || trigger->mProxyId == -1 || !mProxies[trigger->mProxyId].mIsTrigger)
+	{
+		return;
+	}
+
+	mProxies[trigger->mProxyId].mIsTrigger = false;
+	std::erase(mTriggerProxies, trigger->mProxyId);
+	std::erase_if(mTriggerPairs, [trigger](const TriggerPair& pair) {
+		return pair.mTrigger == trigger;
+	});
+}
+
+void CollisionWorld::UpdateTriggers()
+{
+	SyncDynamic();
+
+	// Find this frame's pairs, one broadphase query per trigger
+	mNewTriggerPairs.clear();
+	for (int triggerId : mTriggerProxies)
+	{
+		const Proxy& trigger = mProxies[triggerId];
+		GatherOverlapping(mBoxes.Get(triggerId), trigger.mColl);
+		for (int proxyId : mQueryProxies)
+		{
+			mNewTriggerPairs.emplace_back(TriggerPair{trigger.mSequence, mProxies[proxyId].mSequence,
+													  trigger.mColl, mProxies[proxyId].mColl});
+		}
+	}
+	std::sort(mNewTriggerPairs.begin(), mNewTriggerPairs.end());
+
+	// Walk both sorted lists together: only last frame is an exit, only this
+	// frame is an enter, both is a stay
+	mTriggerEvents.clear();
+	size_t oldIdx = 0;
+	size_t newIdx = 0;
+	while (oldIdx < mTriggerPairs.size() || newIdx < mNewTriggerPairs.size())
+	{
+		if (newIdx == mNewTriggerPairs.size() ||
+			(oldIdx < mTriggerPairs.size() && mTriggerPairs[oldIdx] < mNewTriggerPairs[newIdx]))
+		{
+			mTriggerEvents.emplace_back(TriggerEvent::Exit, mTriggerPairs[oldIdx++]);
+		}
+		else if (oldIdx == mTriggerPairs.size() || mNewTriggerPairs[newIdx] < mTriggerPairs[oldIdx])
+		{
+			mTriggerEvents.emplace_back(TriggerEvent::Enter, mNewTriggerPairs[newIdx++]);
+		}
+		else
+		{
+			mTriggerEvents.emplace_back(TriggerEvent::Stay, mNewTriggerPairs[newIdx++]);
+			oldIdx++;
+		}
+	}
+	mTriggerPairs.swap(mNewTriggerPairs);
+
+	// Callbacks only run once the pairs are stored, since they can add or remove
+	// triggers (destroyed actors stick around until the end of the next update)
+	for (const auto& [event, pair] : mTriggerEvents)
+	{
+		switch (event)
+		{
+		case TriggerEvent::Enter:
+			pair.mTrigger->NotifyTriggerEnter(pair.mOther);
+			break;
+		case TriggerEvent::Stay:
+			pair.mTrigger->NotifyTriggerStay(pair.mOther);
+			break;
+		case TriggerEvent::Exit:
+			pair.mTrigger->NotifyTriggerExit(pair.mOther);
+			break;
+		}
+	}
+}
+
+void CollisionWorld::BuildStaticTree()
+{
+	std::vector<AABB> boxes;
+	mStaticProxies.clear();
+
+	for (int i = 0; i < static_cast<int>(mProxies.size()); i++)
+	{
+		Proxy& proxy = mProxies[i];
+		if (!proxy.mColl || !proxy.mIsStatic)
+		{
+			continue;
+		}
+
+		// Pull static colliders out of the dynamic tree
+		if (proxy.mTreeId != -1)
+		{
+			mDynamicTree.DestroyProxy(proxy.mTreeId);
+			proxy.mTreeId = -1;
+			std::erase(mDynamicProxies, i);
+		}
+
+		const AABB& box = proxy.mColl->GetAABB();
+		proxy.mBoxRevision = proxy.mColl->GetBoxRevision();
+		mBoxes.Set(i, box);
+
+		proxy.mStaticIndex = static_cast<int>(boxes.size());
+		boxes.emplace_back(box);
+		mStaticProxies.emplace_back(i);
+	}
+
+	mStaticTree.Build(boxes);
+	mColliderRevision++;
+}
+
+void CollisionWorld::Clear()
+{
+	for (Proxy& proxy : mProxies)
+	{
+		if (proxy.mColl)
+		{
+			proxy.mColl->mProxyId = -1;
+		}
+	}
+
+	mProxies.clear();
+	mBoxes.Resize(0);
+	mFreeProxies.clear();
+	mDynamicProxies.clear();
+	mDynamicTree.Clear();
+	mStaticTree.Clear();
+	mStaticProxies.clear();
+	mTriggerProxies.clear();
+	mTriggerPairs.clear();
+	mNextSequence = 0;
+	mNextColliderSequence = 0;
+	mNumColliders = 0;
+	// Not reset, so caches from before the clear are never mistaken as valid
+	mColliderRevision++;
+}
+
+void CollisionWorld::SyncDynamic()
+{
+	for (int proxyId : mDynamicProxies)
+	{
+		Proxy& proxy = mProxies[proxyId];
+		const AABB& box = proxy.mColl->GetAABB();
+		if (proxy.mColl->GetBoxRevision() != proxy.mBoxRevision)
+		{
+			proxy.mBoxRevision = proxy.mColl->GetBoxRevision();
+			mBoxes.Set(proxyId, box);
+			mDynamicTree.MoveProxy(proxy.mTreeId, box);
+			if (proxy.mIsCollider)
+			{
+				mColliderRevision++;
+			}
+		}
+	}
+}
+
+void CollisionWorld::QueryOverlaps(const AABB& box, std::vector<CollisionComponent*>& outHits,
+								   const CollisionComponent* querier)
+{
+	outHits.clear();
+	GatherColliders(box, querier);
+	for (int proxyId : mQueryProxies)
+	{
+		outHits.emplace_back(mProxies[proxyId].mColl);
+	}
+}
+
+void CollisionWorld::QueryOverlapping(const AABB& box, const CollisionComponent* querier,
+									 std::vector<CollisionComponent*>& outHits)
+{
+	SyncDynamic();
+	GatherOverlapping(box, querier);
+	std::ranges::sort(mQueryProxies, [this](int a, int b) {
+		return mProxies[a].mSequence < mProxies[b].mSequence;
+	});
+
+	outHits.clear();
+	for (int proxyId : mQueryProxies)
+	{
+		outHits.emplace_back(mProxies[proxyId].mColl);
+	}
+}
+
+void CollisionWorld::GatherOverlapping(const AABB& box, const CollisionComponent* querier)
+{
+	mQueryProxies.clear();
+	auto addProxy = [this, querier](int proxyId) {
+		const Proxy& other = mProxies[proxyId];
+		if (PassesFilter(other, querier) &&
+			GetCollisionResponse(querier->GetLayer(), other.mColl->GetLayer()) ==
+				CollisionResponse::Overlap)
+		{
+			mQueryProxies.emplace_back(proxyId);
+		}
+	};
+
+	mQueryIndices.clear();
+	mStaticTree.Query(box, mQueryIndices);
+	for (int staticIdx : mQueryIndices)
+	{
+		if (mStaticProxies[staticIdx] != -1)
+		{
+			addProxy(mStaticProxies[staticIdx]);
+		}
+	}
+
+	mQueryIndices.clear();
+	mDynamicTree.Query(box, mQueryIndices);
+	for (int proxyId : mQueryIndices)
+	{
+		if (mBoxes.Overlaps(proxyId, box))
+		{
+			addProxy(proxyId);
+		}
+	}
+}
+
+bool CollisionWorld::PassesFilter(const Proxy& proxy, const CollisionComponent* querier) const
+{
+	if (!querier)
+	{
+		return true;
+	}
+	return proxy.mColl != querier && (proxy.mMask & GetLayerBit(querier->GetLayer())) != 0 &&
+		   (querier->GetMask() & proxy.mLayerBit) != 0;
+}
+
+void CollisionWorld::GatherColliders(const AABB& box, const CollisionComponent* querier)
+{
+	SyncDynamic();
+
+	mQueryProxies.clear();
+
+	// Static BVH stores exact boxes
+	mQueryIndices.clear();
+	mStaticTree.Query(box, mQueryIndices);
+	for (int staticIdx : mQueryIndices)
+	{
+		const int PROXY_ID = mStaticProxies[staticIdx];
+		if (PROXY_ID != -1 && mProxies[PROXY_ID].mIsCollider &&
+			PassesFilter(mProxies[PROXY_ID], querier))
+		{
+			mQueryProxies.emplace_back(PROXY_ID);
+		}
+	}
+
+	// Dynamic tree stores fat boxes, so check the real box too
+	mQueryIndices.clear();
+	mDynamicTree.Query(box, mQueryIndices);
+	for (int proxyId : mQueryIndices)
+	{
+		const Proxy& proxy = mProxies[proxyId];
+		if (proxy.mIsCollider && PassesFilter(proxy, querier) && mBoxes.Overlaps(proxyId, box))
+		{
+			mQueryProxies.emplace_back(proxyId);
+		}
+	}
+
+	// Callers resolve collisions one after another, so keep the old ordering
+	std::ranges::sort(mQueryProxies, [this](int a, int b) {
+		return mProxies[a].mColliderSequence < mProxies[b].mColliderSequence;
+	});
+}
+
+Vector3 CollisionWorld::ResolveContacts(const CollisionComponent* coll, const AABB& queryBox,
+										std::vector<Contact>& outContacts)
+{
+	GatherColliders(queryBox, coll);
+	Vector3 center;
+	ResolveCandidates(coll, outContacts, nullptr, center);
+	return center;
+}
+
+Vector3 CollisionWorld::ResolveContactsCached(const CollisionComponent* coll, float queryMargin,
+											  ContactCache& cache,
+											  std::vector<Contact>& outContacts)
+{
+	Vector3 center;
+	if (cache.mIsValid && cache.mRevision == GetColliderRevision())
+	{
+		mQueryProxies.assign(cache.mProxies.begin(), cache.mProxies.end());
+		if (ResolveCandidates(coll, outContacts, &cache, center))
+		{
+			return center;
+		}
+	}
+
+	const AABB START_BOX = coll->GetAABB();
+	AABB queryBox = START_BOX;
+	queryBox.Expand(queryMargin);
+	GatherColliders(queryBox, coll);
+	ResolveCandidates(coll, outContacts, nullptr, center);
+
+	// Refill the cache with what was touched
+	cache.mProxies.clear();
+	for (const Contact& contact : outContacts)
+	{
+		cache.mProxies.emplace_back(contact.mOther->mProxyId);
+	}
+	cache.mCenter = center;
+	cache.mRevision = mColliderRevision;
+
+	// Anything outside the query box is at least the margin away from where the
+	// box started, minus however far it got pushed
+	const Vector3 PUSH = center - coll->GetCenter();
+	float clearance = queryMargin -
+					  Math::Max(Math::Abs(PUSH.x), Math::Max(Math::Abs(PUSH.y), Math::Abs(PUSH.z)));
+
+	// Candidates that weren't touched are kept apart by their widest gap
+	const Vector3 HALF_EXTENTS = coll->GetHalfExtents();
+	const AABB END_BOX(center - HALF_EXTENTS, center + HALF_EXTENTS);
+	const float* aMin = END_BOX.mMin.GetAsFloatPtr();
+	const float* aMax = END_BOX.mMax.GetAsFloatPtr();
+	for (int proxyId : mQueryProxies)
+	{
+		if (std::ranges::find(cache.mProxies, proxyId) != cache.mProxies.end())
+		{
+			continue;
+		}
+
+		const AABB OTHER_BOX = mBoxes.Get(proxyId);
+		const float* bMin = OTHER_BOX.mMin.GetAsFloatPtr();
+		const float* bMax = OTHER_BOX.mMax.GetAsFloatPtr();
+		float gap = -Math::Infinity;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			gap = Math::Max(gap, Math::Max(bMin[axis] - aMax[axis], aMin[axis] - bMax[axis]));
+		}
+		clearance = Math::Min(clearance, gap);
+	}
+
+	// Leave room for rounding when boxes are rebuilt from a moved center
+	cache.mClearance = clearance - CONTACT_CACHE_TOLERANCE;
+	cache.mIsValid = cache.mClearance > 0.0f;
+	return center;
+}
+
+bool CollisionWorld::ResolveCandidates(const CollisionComponent* coll,
+									   std::vector<Contact>& outContacts,
+									   const ContactCache* bounds, Vector3& outCenter)
+{
+	outContacts.clear();
+	// Only blocking pairs push the box
+	std::erase_if(mQueryProxies, [this, coll](int proxyId) {
+		return GetCollisionResponse(coll->GetLayer(), mProxies[proxyId].mColl->GetLayer()) !=
+			   CollisionResponse::Block;
+	});
+
+	// Copy candidate boxes next to each other, padding the last group with boxes
+	// that can't overlap anything
+	const size_t NUM_CANDIDATES = mQueryProxies.size();
+	const size_t NUM_GROUPS = (NUM_CANDIDATES + 3) / 4;
+	const AABB NO_BOX(Vector3(Math::Infinity, Math::Infinity, Math::Infinity),
+					  Vector3(-Math::Infinity, -Math::Infinity, -Math::Infinity));
+	mContactBoxes.Resize(NUM_GROUPS * 4);
+	for (size_t i = 0; i < NUM_GROUPS * 4; i++)
+	{
+		const int IDX = static_cast<int>(i);
+		mContactBoxes.Set(IDX, i < NUM_CANDIDATES ? mBoxes.Get(mQueryProxies[i]) : NO_BOX);
+	}
+	mContactMasks.resize(NUM_GROUPS);
+	mContactSides.resize(NUM_GROUPS * 4);
+	mContactDepths.resize(NUM_GROUPS * 4);
+
+	// Only colliders in the cache can be touched while the box is this close to
+	// where the cache was filled
+	auto inBounds = [bounds](const Vector3& center) {
+		if (!bounds)
+		{
+			return true;
+		}
+		const Vector3 MOVED = center - bounds->mCenter;
+		return Math::Abs(MOVED.x) < bounds->mClearance &&
+			   Math::Abs(MOVED.y) < bounds->mClearance && Math::Abs(MOVED.z) < bounds->mClearance;
+	};
+
+	// Index is the side number ClassifyContacts stores
+	constexpr CollSide SIDES[6] = {CollSide::Back,	CollSide::Front,  CollSide::Left,
+								   CollSide::Right, CollSide::Bottom, CollSide::Top};
+
+	Vector3 center = coll->GetCenter();
+	if (!inBounds(center))
+	{
+		return false;
+	}
+	const Vector3 HALF_EXTENTS = coll->GetHalfExtents();
+	ClassifyContacts(AABB(center - HALF_EXTENTS, center + HALF_EXTENTS), 0);
+
+	for (size_t i = 0; i < NUM_CANDIDATES; i++)
+	{
+		if ((mContactMasks[i / 4] & (1 << (i % 4))) == 0)
+		{
+			continue;
+		}
+
+		const int SIDE = static_cast<int>(mContactSides[i]);
+		Vector3 offset;
+		switch (SIDE / 2)
+		{
+		case 0:
+			offset.x = mContactDepths[i];
+			break;
+		case 1:
+			offset.y = mContactDepths[i];
+			break;
+		default:
+			offset.z = mContactDepths[i];
+			break;
+		}
+		outContacts.emplace_back(Contact{mProxies[mQueryProxies[i]].mColl, SIDES[SIDE], offset});
+
+		// Later candidates have to be tested against the moved box
+		if (offset.x != 0.0f || offset.y != 0.0f || offset.z != 0.0f)
+		{
+			center += offset;
+			if (!inBounds(center))
+			{
+				return false;
+			}
+			ClassifyContacts(AABB(center - HALF_EXTENTS, center + HALF_EXTENTS), (i + 1) / 4);
+		}
+	}
+
+	outCenter = center;
+	return true;
+}
+
+void CollisionWorld::ClassifyContacts(const AABB& box, size_t firstGroup)
+{
+	using namespace Simd;
+	const Float4 A_MIN_X = Set1(box.mMin.x);
+	const Float4 A_MIN_Y = Set1(box.mMin.y);
+	const Float4 A_MIN_Z = Set1(box.mMin.z);
+	const Float4 A_MAX_X = Set1(box.mMax.x);
+	const Float4 A_MAX_Y = Set1(box.mMax.y);
+	const Float4 A_MAX_Z = Set1(box.mMax.z);
+
+	for (size_t g = firstGroup; g < mContactMasks.size(); g++)
+	{
+		const size_t BASE = g * 4;
+		const Float4 B_MIN_X = Load(mContactBoxes.mMinX.data() + BASE);
+		const Float4 B_MIN_Y = Load(mContactBoxes.mMinY.data() + BASE);
+		const Float4 B_MIN_Z = Load(mContactBoxes.mMinZ.data() + BASE);
+		const Float4 B_MAX_X = Load(mContactBoxes.mMaxX.data() + BASE);
+		const Float4 B_MAX_Y = Load(mContactBoxes.mMaxY.data() + BASE);
+		const Float4 B_MAX_Z = Load(mContactBoxes.mMaxZ.data() + BASE);
+
+		// Same test as AABB::Intersects (touching counts)
+		Mask4 overlaps = And(And(LessEqual(B_MIN_X, A_MAX_X), LessEqual(A_MIN_X, B_MAX_X)),
+							 And(LessEqual(B_MIN_Y, A_MAX_Y), LessEqual(A_MIN_Y, B_MAX_Y)));
+		overlaps = And(overlaps, And(LessEqual(B_MIN_Z, A_MAX_Z), LessEqual(A_MIN_Z, B_MAX_Z)));
+		mContactMasks[g] = MoveMask(overlaps);
+		if (mContactMasks[g] == 0)
+		{
+			continue;
+		}
+
+		// Signed distances in the order GetMinOverlap checks them, so ties pick
+		// the same side
+		const Float4 DISTS[6] = {Sub(B_MIN_X, A_MAX_X), Sub(B_MAX_X, A_MIN_X),
+								 Sub(B_MIN_Y, A_MAX_Y), Sub(B_MAX_Y, A_MIN_Y),
+								 Sub(B_MIN_Z, A_MAX_Z), Sub(B_MAX_Z, A_MIN_Z)};
+		Float4 minDist = Abs(DISTS[0]);
+		Float4 depth = DISTS[0];
+		Float4 side = Set1(0.0f);
+		for (int s = 1; s < 6; s++)
+		{
+			const Float4 DIST = Abs(DISTS[s]);
+			const Mask4 CLOSER = Less(DIST, minDist);
+			minDist = Select(CLOSER, DIST, minDist);
+			depth = Select(CLOSER, DISTS[s], depth);
+			side = Select(CLOSER, Set1(static_cast<float>(s)), side);
+		}
+		Store(mContactSides.data() + BASE, side);
+		Store(mContactDepths.data() + BASE, depth);
+	}
+}
+
+void CollisionWorld::TestProxy(int proxyId, const LineSegment& l, const Actor* ignoreActor,
+							   bool collidersOnly, ClosestHit& hit) const
+{
+	const Proxy& proxy = mProxies[proxyId];
+	if ((collidersOnly && !proxy.mIsCollider) || proxy.mColl->GetOwner() == ignoreActor)
+	{
+		return;
+	}
+
+	float t = Math::Infinity;
+	Vector3 norm;
+	const AABB BOX = mBoxes.Get(proxyId);
+	if (IntersectBox(l, BOX.mMin, BOX.mMax, t, norm))
+	{
+		// Ties on t go to the lowest sequence, which is the order the old vector
+		// based cast walked things in
+		const unsigned int SEQUENCE = collidersOnly ? proxy.mColliderSequence : proxy.mSequence;
+		if (t < hit.mT || (t == hit.mT && SEQUENCE < hit.mSequence))
+		{
+			hit.mT = t;
+			hit.mSequence = SEQUENCE;
+			hit.mProxy = proxyId;
+			hit.mNormal = norm;
+		}
+	}
+}
+
+void CollisionWorld::FillCastInfo(const LineSegment& l, const ClosestHit& hit,
+								  CastInfo& outInfo) const
+{
+	outInfo.mPoint = l.PointOnSegment(hit.mT);
+	outInfo.mNormal = hit.mNormal;
+	outInfo.mActor = mProxies[hit.mProxy].mColl->GetOwner();
+}
+
+bool CollisionWorld::SegmentCast(const LineSegment& l, CastInfo& outInfo,
+								 const Actor* ignoreActor, bool collidersOnly)
+{
+	SyncDynamic();
+
+	ClosestHit hit;
+	auto testProxy = [&](int proxyId, float maxT) {
+		TestProxy(proxyId, l, ignoreActor, collidersOnly, hit);
+		return Math::Min(maxT, hit.mT);
+	};
+
+	const AABBRay RAY(l.mStart, l.mEnd, SEGMENT_CAST_FUZZ);
+	mStaticTree.RayCast(RAY, 1.0f, [&](int staticIdx, float maxT) {
+		const int PROXY_ID = mStaticProxies[staticIdx];
+		return PROXY_ID == -1 ? maxT : testProxy(PROXY_ID, maxT);
+	});
+	mDynamicTree.RayCast(RAY, Math::Min(1.0f, hit.mT), testProxy);
+
+	if (hit.mProxy == -1)
+	{
+		return false;
+	}
+
+	FillCastInfo(l, hit, outInfo);
+	return true;
+}
+
+void CollisionWorld::SegmentCastPacket(std::span<SegmentCastQuery> queries, bool collidersOnly)
+{
+	SyncDynamic();
+
+	AABBRayPacket packet;
+	ClosestHit hits[PACKET_SIZE];
+
+	for (size_t first = 0; first < queries.size(); first += PACKET_SIZE)
+	{
+		std::span<SegmentCastQuery> batch = queries.subspan(
+			first, Math::Min(queries.size() - first, static_cast<size_t>(PACKET_SIZE)));
+
+		packet.Reset(static_cast<int>(batch.size()), SEGMENT_CAST_FUZZ);
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			packet.SetLane(static_cast<int>(i), batch[i].mSegment.mStart, batch[i].mSegment.mEnd,
+						   1.0f);
+			hits[i] = ClosestHit();
+		}
+
+		// Narrowphase for each lane that reached this proxy, then shrink that lane
+		auto testProxy = [&](int proxyId, unsigned int laneMask) {
+			for (int lane = 0; laneMask != 0; lane++, laneMask >>= 1)
+			{
+				if (laneMask & 1)
+				{
+					TestProxy(proxyId, batch[lane].mSegment, batch[lane].mIgnoreActor,
+							  collidersOnly, hits[lane]);
+					packet.mMaxT[lane] = Math::Min(packet.mMaxT[lane], hits[lane].mT);
+				}
+			}
+		};
+
+		mStaticTree.RayCastPacket(packet, [&](int staticIdx, unsigned int laneMask) {
+			const int PROXY_ID = mStaticProxies[staticIdx];
+			if (PROXY_ID != -1)
+			{
+				testProxy(PROXY_ID, laneMask);
+			}
+		});
+		mDynamicTree.RayCastPacket(packet, testProxy);
+
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			batch[i].mHit = hits[i].mProxy != -1;
+			if (batch[i].mHit)
+			{
+				FillCastInfo(batch[i].mSegment, hits[i], batch[i].mInfo);
+			}
+		}
+	}
+}
+
+bool CollisionWorld::SweepBox(const AABB& box, const Vector3& delta,
+							  const CollisionComponent* mover, float& outTime, Vector3& outNormal)
+{
+	const AABB END_BOX(box.mMin + delta, box.mMax + delta);
+	QueryOverlaps(AABB::Union(box, END_BOX), mSweepHits, mover);
+
+	const float* aMin = box.mMin.GetAsFloatPtr();
+	const float* aMax = box.mMax.GetAsFloatPtr();
+	const float* endMin = END_BOX.mMin.GetAsFloatPtr();
+	const float* endMax = END_BOX.mMax.GetAsFloatPtr();
+	const float* d = delta.GetAsFloatPtr();
+	const Vector3 AXES[3] = {Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ};
+
+	bool found = false;
+	outTime = Math::Infinity;
+	for (CollisionComponent* other : mSweepHits)
+	{
+		const AABB OTHER_BOX = other->GetAABB();
+		const float* bMin = OTHER_BOX.mMin.GetAsFloatPtr();
+		const float* bMax = OTHER_BOX.mMax.GetAsFloatPtr();
+
+		// Time the box starts/stops overlapping on each axis
+		float tEntry = -Math::Infinity;
+		float tExit = Math::Infinity;
+		int entryAxis = -1;
+		bool separated = false;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (d[axis] == 0.0f)
+			{
+				// Not moving on this axis, so it has to overlap the whole time
+				separated = aMax[axis] < bMin[axis] || bMax[axis] < aMin[axis];
+				if (separated)
+				{
+					break;
+				}
+				continue;
+			}
+
+			float t0 = (bMin[axis] - aMax[axis]) / d[axis];
+			float t1 = (bMax[axis] - aMin[axis]) / d[axis];
+			float tNear = Math::Min(t0, t1);
+			float tFar = Math::Max(t0, t1);
+			if (tNear > tEntry)
+			{
+				tEntry = tNear;
+				entryAxis = axis;
+			}
+			tExit = Math::Min(tExit, tFar);
+		}
+
+		// Overlapping from the start is left to the regular overlap fix
+		if (separated || entryAxis == -1 || tEntry > tExit || tEntry < 0.0f || tEntry > 1.0f)
+		{
+			continue;
+		}
+
+		// Only step in if the end position would get this one wrong: either we
+		// passed right through it, or we're deep enough that the smaller push is
+		// out the far side
+		bool needsSweep = !END_BOX.Intersects(OTHER_BOX);
+		if (!needsSweep)
+		{
+			const int A = entryAxis;
+			float entryDepth = d[A] > 0.0f ? endMax[A] - bMin[A] : bMax[A] - endMin[A];
+			float farDepth = d[A] > 0.0f ? bMax[A] - endMin[A] : endMax[A] - bMin[A];
+			needsSweep = farDepth < entryDepth;
+		}
+
+		if (needsSweep && tEntry < outTime)
+		{
+			outTime = tEntry;
+			outNormal = d[entryAxis] > 0.0f ? AXES[entryAxis] * -1.0f : AXES[entryAxis];
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+bool CollisionWorld::SweepMove(const CollisionComponent* mover, Vector3& inOutDelta,
+							   Vector3& outNormal, bool slide)
+{
+	bool changed = false;
+	AABB current = mover->GetAABB();
+	Vector3 remaining = inOutDelta;
+	Vector3 applied = Vector3::Zero;
+
+	for (int i = 0; i < MAX_SWEEP_ITERATIONS; i++)
+	{
+		float t = 0.0f;
+		Vector3 normal;
+		if (!SweepBox(current, remaining, mover, t, normal))
+		{
+			applied += remaining;
+			remaining = Vector3::Zero;
+			break;
+		}
+
+		changed = true;
+		outNormal = normal;
+
+		// Stop just inside the surface
+		Vector3 step = remaining * t - normal * SWEEP_CONTACT_DEPTH;
+		applied += step;
+		current.mMin += step;
+		current.mMax += step;
+
+		if (!slide)
+		{
+			remaining = Vector3::Zero;
+			break;
+		}
+
+		// Whatever is left of the move continues along the surface
+		remaining *= 1.0f - t;
+		remaining -= normal * Vector3::Dot(remaining, normal);
+	}
+
+	inOutDelta = applied;
+	return changed;
+}
@@ -0,0 +1,321 @@
+#pragma once
+#include "AABB.h"
+#include "DynamicAABBTree.h"
+#include "StaticBVH.h"
+#include "SegmentCast.h"
+#include <span>
+#include <utility>
+#include <vector>
+
+class Actor;
+class CollisionComponent;
+enum class CollSide;
+enum class CollisionLayer;
+
+// One segment of a packet cast (see CollisionWorld::SegmentCastPacket)
+struct SegmentCastQuery
+{
+	LineSegment mSegment;
+	const Actor* mIgnoreActor = nullptr;
+
+	// Filled in by the cast
+	CastInfo mInfo;
+	bool mHit = false;
+};
+
+// One collider a box was pushed out of (see CollisionWorld::ResolveContacts)
+struct Contact
+{
+	CollisionComponent* mOther = nullptr;
+	// Side of mOther that was hit
+	CollSide mSide;
+	// How far the box was moved to stop overlapping mOther
+	Vector3 mOffset;
+};
+
+// Colliders a box was touching the last time ResolveContactsCached did a full
+// query, kept so later calls can skip the query while the box stays put
+struct ContactCache
+{
+	// Proxy ids of the touched colliders, in add order
+	std::vector<int> mProxies;
+	// Resolved center of the box when the cache was filled
+	Vector3 mCenter;
+	// How far (on any axis) the box can get from mCenter before it could touch a
+	// collider that isn't in mProxies
+	float mClearance = 0.0f;
+	// CollisionWorld::GetColliderRevision when the cache was filled
+	unsigned int mRevision = 0;
+	bool mIsValid = false;
+};
+
+// Broadphase for every collision component in the level.
+// Every CollisionComponent registers itself so segment casts can hit it (the
+// player, pellets, portals, triggers...). Actors that block movement are also
+// added as colliders through Game::AddCollider.
+// Colliders that never move (blocks, collidable props) go into a static BVH that
+// is built once the level is loaded. Everything else (doors, turrets, catchers,
+// launchers...) lives in a dynamic AABB tree that is refit as they move.
+class CollisionWorld
+{
+public:
+	// Called by CollisionComponent when it's created/destroyed
+	void RegisterComponent(CollisionComponent* coll);
+	void UnregisterComponent(CollisionComponent* coll);
+
+	// Mark a registered component as a collider. Static colliders must not move
+	// after BuildStaticTree.
+	void AddCollider(CollisionComponent* coll, bool isStatic);
+	// Stop treating the component as a collider (it can still be hit by casts)
+	void RemoveCollider(CollisionComponent* coll);
+
+	// Mark a registered component as a trigger volume. Once per frame
+	// UpdateTriggers finds everything it overlaps (that its layer responds to with
+	// Overlap) and calls its enter/stay/exit callbacks.
+	void AddTrigger(CollisionComponent* trigger);
+	void RemoveTrigger(CollisionComponent* trigger);
+	void UpdateTriggers();
+
+	// Build the static BVH from all static colliders (call after a level is loaded)
+	void BuildStaticTree();
+
+	// Called by CollisionComponent when its layer or mask changes
+	void UpdateFilter(CollisionComponent* coll);
+
+	// Remove everything
+	void Clear();
+
+	// Collects every collider overlapping box, in the order they were added
+	// (the same order the old collider vector was walked in). With a querier, it
+	// is left out and so is anything its layer can't interact with.
+	void QueryOverlaps(const AABB& box, std::vector<CollisionComponent*>& outHits,
+					   const CollisionComponent* querier = nullptr);
+
+	// Collects every component overlapping box that querier's layer responds to
+	// with Overlap (colliders or not), in the order they were registered
+	void QueryOverlapping(const AABB& box, const CollisionComponent* querier,
+						  std::vector<CollisionComponent*>& outHits);
+
+	// Pushes coll out of every blocking collider overlapping queryBox that it touches, one
+	// collider at a time in add order, the same way GetMinOverlap followed by a
+	// move for each collider would. The overlap test and minimum axis are found for
+	// four colliders at once. Contacts are appended in the order they were resolved
+	// and the resolved center of coll is returned (coll itself isn't moved).
+	Vector3 ResolveContacts(const CollisionComponent* coll, const AABB& queryBox,
+							std::vector<Contact>& outContacts);
+
+	// Same as ResolveContacts with queryBox being coll's box grown by queryMargin,
+	// but only rechecks the colliders in cache while coll stays within the cache's
+	// clearance and no collider was added, removed or moved. The full query runs
+	// (and refills the cache) otherwise, so the result is always the same.
+	Vector3 ResolveContactsCached(const CollisionComponent* coll, float queryMargin,
+								  ContactCache& cache, std::vector<Contact>& outContacts);
+
+	// Changes whenever a collider is added, removed or moves
+	unsigned int GetColliderRevision()
+	{
+		SyncDynamic();
+		return mColliderRevision;
+	}
+
+	// Closest hit along the segment. With collidersOnly false, every collision
+	// component is considered (like casting against all actors).
+	bool SegmentCast(const LineSegment& l, CastInfo& outInfo, const Actor* ignoreActor = nullptr,
+					 bool collidersOnly = true);
+
+	// Casts a batch of segments, up to PACKET_SIZE at a time with one shared tree
+	// traversal and SIMD slab tests. Each result matches what SegmentCast returns
+	// for that segment on its own.
+	void SegmentCastPacket(std::span<SegmentCastQuery> queries, bool collidersOnly = true);
+
+	// Continuous collision for mover moving by inOutDelta. The move is left alone
+	// unless it would pass through a collider, or end so deep in one that the usual
+	// overlap fix would push it out the far side. Then it stops just inside the
+	// first such collider (so the overlap fix still sees the contact) and, with
+	// slide, continues along that surface. Returns true if the move was changed, in
+	// which case outNormal is the last surface hit.
+	// Only colliders mover's layer can interact with are considered.
+	bool SweepMove(const CollisionComponent* mover, Vector3& inOutDelta, Vector3& outNormal,
+				   bool slide = true);
+
+	size_t GetNumColliders() const { return mNumColliders; }
+
+	static constexpr int PACKET_SIZE = AABBRayPacket::MAX_LANES;
+
+private:
+	// SweepMove tunables
+	static constexpr int MAX_SWEEP_ITERATIONS = 3;
+	// How far inside a collider a swept move stops
+	static constexpr float SWEEP_CONTACT_DEPTH = 0.01f;
+	// Taken off a contact cache's clearance to cover rounding
+	static constexpr float CONTACT_CACHE_TOLERANCE = 0.01f;
+
+	struct Proxy
+	{
+		CollisionComponent* mColl = nullptr;
+		// Increases with every registration, used to break ties like the actor list did
+		unsigned int mSequence = 0;
+		// Increases with every AddCollider, used to keep collider results in add order
+		unsigned int mColliderSequence = 0;
+		// Leaf in the dynamic tree, or -1
+		int mTreeId = -1;
+		// Entry in the static BVH, or -1
+		int mStaticIndex = -1;
+		// Component box revision last copied into mBoxes
+		unsigned int mBoxRevision = 0;
+		// Copied from the component so queries can reject pairs without touching it
+		unsigned int mLayerBit = 0;
+		unsigned int mMask = 0;
+		bool mIsCollider = false;
+		bool mIsStatic = false;
+		bool mIsTrigger = false;
+	};
+
+	// Something overlapping a trigger. Sequences identify the proxies (ids get
+	// reused) and give a stable order.
+	struct TriggerPair
+	{
+		unsigned int mTriggerSequence = 0;
+		unsigned int mOtherSequence = 0;
+		CollisionComponent* mTrigger = nullptr;
+		CollisionComponent* mOther = nullptr;
+
+		bool operator<(const TriggerPair& rhs) const
+		{
+			if (mTriggerSequence != rhs.mTriggerSequence)
+			{
+				return mTriggerSequence < rhs.mTriggerSequence;
+			}
+			return mOtherSequence < rhs.mOtherSequence;
+		}
+	};
+
+	// World box of every proxy (by proxy id), kept as separate min/max arrays so
+	// queries can stream over them
+	struct BoxArrays
+	{
+		void Resize(size_t size)
+		{
+			mMinX.resize(size);
+			mMinY.resize(size);
+			mMinZ.resize(size);
+			mMaxX.resize(size);
+			mMaxY.resize(size);
+			mMaxZ.resize(size);
+		}
+
+		void Set(int idx, const AABB& box)
+		{
+			mMinX[idx] = box.mMin.x;
+			mMinY[idx] = box.mMin.y;
+			mMinZ[idx] = box.mMin.z;
+			mMaxX[idx] = box.mMax.x;
+			mMaxY[idx] = box.mMax.y;
+			mMaxZ[idx] = box.mMax.z;
+		}
+
+		AABB Get(int idx) const
+		{
+			return {Vector3(mMinX[idx], mMinY[idx], mMinZ[idx]),
+					Vector3(mMaxX[idx], mMaxY[idx], mMaxZ[idx])};
+		}
+
+		// Same test as AABB::Intersects (touching counts)
+		bool Overlaps(int idx, const AABB& box) const
+		{
+			bool noIntersection = mMaxX[idx] < box.mMin.x || mMaxY[idx] < box.mMin.y ||
+								  mMaxZ[idx] < box.mMin.z || box.mMax.x < mMinX[idx] ||
+								  box.mMax.y < mMinY[idx] || box.mMax.z < mMinZ[idx];
+			return !noIntersection;
+		}
+
+		std::vector<float> mMinX;
+		std::vector<float> mMinY;
+		std::vector<float> mMinZ;
+		std::vector<float> mMaxX;
+		std::vector<float> mMaxY;
+		std::vector<float> mMaxZ;
+	};
+
+	// Closest hit so far for one segment
+	struct ClosestHit
+	{
+		float mT = Math::Infinity;
+		unsigned int mSequence = 0;
+		int mProxy = -1;
+		Vector3 mNormal;
+	};
+
+	// Narrowphase against one proxy, updates hit if this is closer
+	void TestProxy(int proxyId, const LineSegment& l, const Actor* ignoreActor,
+				   bool collidersOnly, ClosestHit& hit) const;
+	void FillCastInfo(const LineSegment& l, const ClosestHit& hit, CastInfo& outInfo) const;
+
+	// Earliest time of impact in [0, 1] of box moving by delta against the
+	// colliders that need continuous collision (see SweepMove)
+	bool SweepBox(const AABB& box, const Vector3& delta, const CollisionComponent* mover,
+				  float& outTime, Vector3& outNormal);
+
+	// Colliders overlapping box into mQueryProxies, in add order (filtered by
+	// querier like QueryOverlaps)
+	void GatherColliders(const AABB& box, const CollisionComponent* querier);
+	// Whether the layers and masks of a proxy and querier let them interact
+	bool PassesFilter(const Proxy& proxy, const CollisionComponent* querier) const;
+	// Any component overlapping box that querier overlaps into mQueryProxies,
+	// unordered (dynamic tree must already be synced)
+	void GatherOverlapping(const AABB& box, const CollisionComponent* querier);
+
+	// Runs the contact resolution for coll against the candidates in
+	// mQueryProxies. With bounds, gives up (returning false) as soon as the box
+	// would leave the bounds' clearance.
+	bool ResolveCandidates(const CollisionComponent* coll, std::vector<Contact>& outContacts,
+						   const ContactCache* bounds, Vector3& outCenter);
+
+	// For every contact candidate from firstGroup on, whether it overlaps box, the
+	// side of minimum overlap and the signed push out distance along that side
+	void ClassifyContacts(const AABB& box, size_t firstGroup);
+
+	// Copy boxes into mBoxes and refit dynamic tree leaves for anything that moved
+	// since the last query
+	void SyncDynamic();
+
+	std::vector<Proxy> mProxies;
+	BoxArrays mBoxes;
+	std::vector<int> mFreeProxies;
+	// Proxies currently in the dynamic tree
+	std::vector<int> mDynamicProxies;
+
+	DynamicAABBTree mDynamicTree;
+	StaticBVH mStaticTree;
+	// Static BVH entry -> proxy id (-1 once that collider is removed)
+	std::vector<int> mStaticProxies;
+
+	// Scratch space for queries
+	std::vector<int> mQueryProxies;
+	std::vector<int> mQueryIndices;
+	std::vector<CollisionComponent*> mSweepHits;
+
+	// Trigger proxies in the order they were added, and what overlapped them
+	// last frame (sorted)
+	std::vector<int> mTriggerProxies;
+	std::vector<TriggerPair> mTriggerPairs;
+	std::vector<TriggerPair> mNewTriggerPairs;
+	enum class TriggerEvent
+	{
+		Enter,
+		Stay,
+		Exit
+	};
+	std::vector<std::pair<TriggerEvent, TriggerPair>> mTriggerEvents;
+
+	// Contact candidates for ResolveContacts (padded to groups of four)
+	BoxArrays mContactBoxes;
+	std::vector<int> mContactMasks;
+	std::vector<float> mContactSides;
+	std::vector<float> mContactDepths;
+
+	unsigned int mNextSequence = 0;
+	unsigned int mNextColliderSequence = 0;
+	unsigned int mColliderRevision = 0;
+	size_t mNumColliders = 0;
+};
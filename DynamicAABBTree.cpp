@@ -0,0 +1,216 @@
+#include "DynamicAABBTree.h"
+
+int DynamicAABBTree::CreateProxy(const AABB& box, int userData)
+{
+	int proxyId = AllocateNode();
+
+	AABB fat = box;
+	fat.Expand(FAT_MARGIN);
+	mNodes[proxyId].mBox = fat;
+	mNodes[proxyId].mUserData = userData;
+
+	InsertLeaf(proxyId);
+	return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int proxyId)
+{
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+}
+
+bool DynamicAABBTree::MoveProxy(int proxyId, const AABB& box)
+{
+	// Still inside the fat box, nothing to do
+	if (mNodes[proxyId].mBox.Contains(box))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxyId);
+
+	AABB fat = box;
+	fat.Expand(FAT_MARGIN);
+	mNodes[proxyId].mBox = fat;
+
+	InsertLeaf(proxyId);
+	return true;
+}
+
+void DynamicAABBTree::Query(const AABB& box, std::vector<int>& outUserData) const
+{
+	if (mRoot == NULL_NODE)
+	{
+		return;
+	}
+
+	std::vector<int> stack;
+	stack.emplace_back(mRoot);
+
+	while (!stack.empty())
+	{
+		const Node& node = mNodes[stack.back()];
+		stack.pop_back();
+
+		if (!node.mBox.Intersects(box))
+		{
+			continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			outUserData.emplace_back(node.mUserData);
+		}
+		else
+		{
+			stack.emplace_back(node.mChild1);
+			stack.emplace_back(node.mChild2);
+		}
+	}
+}
+
+void DynamicAABBTree::Clear()
+{
+	mNodes.clear();
+	mRoot = NULL_NODE;
+	mFreeList = NULL_NODE;
+}
+
+int DynamicAABBTree::AllocateNode()
+{
+	if (mFreeList == NULL_NODE)
+	{
+		mNodes.emplace_back();
+		return static_cast<int>(mNodes.size()) - 1;
+	}
+
+	int nodeId = mFreeList;
+	mFreeList = mNodes[nodeId].mParent;
+	mNodes[nodeId] = Node();
+	return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int nodeId)
+{
+	mNodes[nodeId] = Node();
+	mNodes[nodeId].mParent = mFreeList;
+	mFreeList = nodeId;
+}
+
+void DynamicAABBTree::InsertLeaf(int leaf)
+{
+	if (mRoot == NULL_NODE)
+	{
+		mRoot = leaf;
+		mNodes[leaf].mParent = NULL_NODE;
+		return;
+	}
+
+	// Walk down picking the child that grows the least (surface area heuristic)
+	const AABB LEAF_BOX = mNodes[leaf].mBox;
+	int index = mRoot;
+	while (!mNodes[index].IsLeaf())
+	{
+		const Node& node = mNodes[index];
+		float area = node.mBox.SurfaceArea();
+		float combinedArea = AABB::Union(node.mBox, LEAF_BOX).SurfaceArea();
+
+		// Cost of making a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [this, &LEAF_BOX, inheritanceCost](int child) {
+			const AABB& childBox = mNodes[child].mBox;
+			float newArea = AABB::Union(childBox, LEAF_BOX).SurfaceArea();
+			if (mNodes[child].IsLeaf())
+			{
+				return newArea + inheritanceCost;
+			}
+			return newArea - childBox.SurfaceArea() + inheritanceCost;
+		};
+
+		float cost1 = descendCost(node.mChild1);
+		float cost2 = descendCost(node.mChild2);
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		index = cost1 < cost2 ? node.mChild1 : node.mChild2;
+	}
+
+	// Make a new parent for the chosen sibling and the leaf
+	const int SIBLING = index;
+	const int OLD_PARENT = mNodes[SIBLING].mParent;
+	const int NEW_PARENT = AllocateNode();
+	mNodes[NEW_PARENT].mParent = OLD_PARENT;
+	mNodes[NEW_PARENT].mBox = AABB::Union(LEAF_BOX, mNodes[SIBLING].mBox);
+	mNodes[NEW_PARENT].mChild1 = SIBLING;
+	mNodes[NEW_PARENT].mChild2 = leaf;
+	mNodes[SIBLING].mParent = NEW_PARENT;
+	mNodes[leaf].mParent = NEW_PARENT;
+
+	if (OLD_PARENT == NULL_NODE)
+	{
+		mRoot = NEW_PARENT;
+	}
+	else if (mNodes[OLD_PARENT].mChild1 == SIBLING)
+	{
+		mNodes[OLD_PARENT].mChild1 = NEW_PARENT;
+	}
+	else
+	{
+		mNodes[OLD_PARENT].mChild2 = NEW_PARENT;
+	}
+
+	RefitAncestors(OLD_PARENT);
+}
+
+void DynamicAABBTree::RemoveLeaf(int leaf)
+{
+	if (leaf == mRoot)
+	{
+		mRoot = NULL_NODE;
+		return;
+	}
+
+	// The leaf's sibling takes the place of their parent
+	const int PARENT = mNodes[leaf].mParent;
+	const int GRAND_PARENT = mNodes[PARENT].mParent;
+	const int SIBLING = mNodes[PARENT].mChild1 == leaf ? mNodes[PARENT].mChild2
+													   : mNodes[PARENT].mChild1;
+
+	if (GRAND_PARENT == NULL_NODE)
+	{
+		mRoot = SIBLING;
+		mNodes[SIBLING].mParent = NULL_NODE;
+	}
+	else
+	{
+		if (mNodes[GRAND_PARENT].mChild1 == PARENT)
+		{
+			mNodes[GRAND_PARENT].mChild1 = SIBLING;
+		}
+		else
+		{
+			mNodes[GRAND_PARENT].mChild2 = SIBLING;
+		}
+		mNodes[SIBLING].mParent = GRAND_PARENT;
+	}
+
+	FreeNode(PARENT);
+	mNodes[leaf].mParent = NULL_NODE;
+	RefitAncestors(GRAND_PARENT);
+}
+
+void DynamicAABBTree::RefitAncestors(int nodeId)
+{
+	while (nodeId != NULL_NODE)
+	{
+		Node& node = mNodes[nodeId];
+		node.mBox = AABB::Union(mNodes[node.mChild1].mBox, mNodes[node.mChild2].mBox);
+		nodeId = node.mParent;
+	}
+}
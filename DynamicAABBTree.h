@@ -0,0 +1,159 @@
+#pragma once
+#include "AABB.h"
+#include "AABBRayPacket.h"
+#include <utility>
+#include <vector>
+
+// Incrementally updated AABB tree for boxes that move or get added/removed at runtime.
+// Leaves store a "fat" box so small movements don't require touching the tree.
+class DynamicAABBTree
+{
+public:
+	// Insert a box, returns the proxy (leaf node) id
+	int CreateProxy(const AABB& box, int userData);
+	void DestroyProxy(int proxyId);
+
+	// Update a proxy with its current box. Only reinserts the leaf when the box
+	// has left the fat box. Returns true if the tree changed.
+	bool MoveProxy(int proxyId, const AABB& box);
+
+	int GetUserData(int proxyId) const { return mNodes[proxyId].mUserData; }
+	const AABB& GetFatAABB(int proxyId) const { return mNodes[proxyId].mBox; }
+
+	// Appends the user data of every proxy whose fat box overlaps box
+	void Query(const AABB& box, std::vector<int>& outUserData) const;
+
+	// Walks the tree front to back along ray for t in [0, maxT]. For every fat box
+	// the ray hits, calls hitFunc(userData, maxT), which returns the new maxT.
+	template <typename HitFunc>
+	void RayCast(const AABBRay& ray, float maxT, HitFunc&& hitFunc) const
+	{
+		float entryT = 0.0f;
+		if (mRoot == NULL_NODE || !mNodes[mRoot].mBox.RayIntersects(ray, maxT, entryT))
+		{
+			return;
+		}
+
+		mRayStack.clear();
+		mRayStack.emplace_back(mRoot, entryT);
+
+		while (!mRayStack.empty())
+		{
+			auto [nodeId, nodeT] = mRayStack.back();
+			mRayStack.pop_back();
+			if (nodeT > maxT)
+			{
+				continue;
+			}
+
+			const Node& node = mNodes[nodeId];
+			if (node.IsLeaf())
+			{
+				maxT = hitFunc(node.mUserData, maxT);
+				continue;
+			}
+
+			float t1 = 0.0f;
+			float t2 = 0.0f;
+			bool hit1 = mNodes[node.mChild1].mBox.RayIntersects(ray, maxT, t1);
+			bool hit2 = mNodes[node.mChild2].mBox.RayIntersects(ray, maxT, t2);
+			// Far child first so the near one is on top
+			if (hit1 && hit2 && t1 <= t2)
+			{
+				mRayStack.emplace_back(node.mChild2, t2);
+				mRayStack.emplace_back(node.mChild1, t1);
+			}
+			else
+			{
+				if (hit1)
+				{
+					mRayStack.emplace_back(node.mChild1, t1);
+				}
+				if (hit2)
+				{
+					mRayStack.emplace_back(node.mChild2, t2);
+				}
+			}
+		}
+	}
+
+	void Clear();
+
+	// How far the fat box extends past the real box on every side
+	static constexpr float FAT_MARGIN = 8.0f;
+
+	// Packet version of RayCast, calls hitFunc(userData, laneMask) for every fat
+	// box any lane hits
+	template <typename HitFunc>
+	void RayCastPacket(const AABBRayPacket& packet, HitFunc&& hitFunc) const
+	{
+		if (mRoot == NULL_NODE)
+		{
+			return;
+		}
+
+		mPacketStack.clear();
+		mPacketStack.emplace_back(mRoot);
+
+		while (!mPacketStack.empty())
+		{
+			const Node& node = mNodes[mPacketStack.back()];
+			mPacketStack.pop_back();
+
+			unsigned int laneMask = packet.Intersect(node.mBox);
+			if (laneMask == 0)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				hitFunc(node.mUserData, laneMask);
+				continue;
+			}
+
+			// Near child (along the packet direction) on top
+			Vector3 offset = mNodes[node.mChild2].mBox.GetCenter() -
+							 mNodes[node.mChild1].mBox.GetCenter();
+			if (Vector3::Dot(offset, packet.mAverageDir) >= 0.0f)
+			{
+				mPacketStack.emplace_back(node.mChild2);
+				mPacketStack.emplace_back(node.mChild1);
+			}
+			else
+			{
+				mPacketStack.emplace_back(node.mChild1);
+				mPacketStack.emplace_back(node.mChild2);
+			}
+		}
+	}
+
+private:
+	struct Node
+	{
+		AABB mBox;
+		int mParent = NULL_NODE;
+		int mChild1 = NULL_NODE;
+		int mChild2 = NULL_NODE;
+		int mUserData = -1;
+
+		bool IsLeaf() const { return mChild1 == NULL_NODE; }
+	};
+
+	int AllocateNode();
+	void FreeNode(int nodeId);
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	// Refit boxes from node up to the root
+	void RefitAncestors(int nodeId);
+
+	std::vector<Node> mNodes;
+	int mRoot = NULL_NODE;
+	// Head of the free list (threaded through mParent)
+	int mFreeList = NULL_NODE;
+	// Scratch stack for RayCast (node, entry t)
+	mutable std::vector<std::pair<int, float>> mRayStack;
+	mutable std::vector<int> mPacketStack;
+
+	static constexpr int NULL_NODE = -1;
+};
@@ -14,6 +14,15 @@ EnergyCatcher::EnergyCatcher()
 
 	mColl = CreateComponent<CollisionComponent>();
 	mColl->SetSize(Vector3(50.0f, 50.0f, 50.0f));
+	mColl->SetLayer(CollisionLayer::Energy);
+
+	// Only catch once, if not already activated
+	mColl->SetOnOverlap([this](CollisionComponent* other) {
+		if (other->GetLayer() == CollisionLayer::Pellet && !mActivated)
+		{
+			CatchPellet(static_cast<Pellet*>(other->GetOwner()));
+		}
+	});
 
 	gGame.AddCollider(this);
 }
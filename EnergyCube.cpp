@@ -6,6 +6,8 @@
 #include "MeshComponent.h"
 #include "CollisionComponent.h"
 #include "Renderer.h"
+#include "Pellet.h"
+#include "RigidBodyComponent.h"
 
 EnergyCube::EnergyCube()
 {
@@ -14,9 +16,31 @@ EnergyCube::EnergyCube()
 
 	CollisionComponent* coll = CreateComponent<CollisionComponent>();
 	coll->SetSize(Vector3(25.0f, 25.0f, 25.0f));
+	coll->SetLayer(CollisionLayer::Energy);
+
+	// Pellets that go through turn green
+	coll->SetOnOverlap([](CollisionComponent* other) {
+		if (other->GetLayer() == CollisionLayer::Pellet)
+		{
+			static_cast<Pellet*>(other->GetOwner())->TurnGreen();
+		}
+	});
 
 	// Is a collider
 	gGame.AddCollider(this);
+
+	// Rests where it's placed until something knocks into it
+	mBody = CreateComponent<RigidBodyComponent>();
+
+	// Keeps its speed through portals
+	mPortalPolicy.mCooldown = TELEPORT_COOLDOWN;
+	mPortalPolicy.mOnTeleport = [this](const PortalTransfer& transfer) {
+		GetTransform().SetPosition(transfer.mExitPosition);
+		mBody->SetVelocity(transfer.TransformVector(mBody->GetVelocity()) +
+						   transfer.mExitForward * EXIT_SPEED);
+		mBody->Wake();
+	};
+	mBody->SetPortalPolicy(&mPortalPolicy);
 }
 
 EnergyCube::~EnergyCube()
@@ -3,6 +3,9 @@
 //
 #pragma once
 #include "Actor.h"
+#include "PortalSystem.h"
+
+class RigidBodyComponent;
 
 class EnergyCube : public Actor
 {
@@ -10,4 +13,12 @@ protected:
 	EnergyCube();
 	~EnergyCube() override;
 	friend class Game;
+
+private:
+	static constexpr float TELEPORT_COOLDOWN = 0.25f;
+	// Added along the exit portal's forward so it comes out clear of the wall
+	static constexpr float EXIT_SPEED = 250.0f;
+
+	RigidBodyComponent* mBody = nullptr;
+	PortalPolicy mPortalPolicy;
 };
\ No newline at end of file
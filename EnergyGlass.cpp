@@ -15,6 +15,7 @@ EnergyGlass::EnergyGlass()
 
 	CollisionComponent* coll = CreateComponent<CollisionComponent>();
 	coll->SetSize(Vector3(1.0f, 1.0f, 1.0f));
+	coll->SetLayer(CollisionLayer::Glass);
 
 	// Is a collider
 	gGame.AddCollider(this);
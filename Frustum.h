@@ -0,0 +1,160 @@
+#pragma once
+#include "Math.h"
+#include "AABB.h"
+
+// Part of the screen in normalized device coordinates (-1 to 1 on both axes)
+struct ScreenRect
+{
+	float mMinX = -1.0f;
+	float mMinY = -1.0f;
+	float mMaxX = 1.0f;
+	float mMaxY = 1.0f;
+
+	bool IsEmpty() const { return mMinX >= mMaxX || mMinY >= mMaxY; }
+
+	void Intersect(const ScreenRect& other)
+	{
+		mMinX = Math::Max(mMinX, other.mMinX);
+		mMinY = Math::Max(mMinY, other.mMinY);
+		mMaxX = Math::Min(mMaxX, other.mMaxX);
+		mMaxY = Math::Min(mMaxY, other.mMaxY);
+	}
+
+	// Where box lands on screen under a (row vector) view-projection (not limited
+	// to the screen). If part of it is behind the camera, that could be anywhere,
+	// so it's the whole screen and this returns false.
+	static bool FromBox(const AABB& box, const Matrix4& viewProj, ScreenRect& outRect)
+	{
+		outRect = ScreenRect{1.0f, 1.0f, -1.0f, -1.0f};
+		for (int i = 0; i < 8; i++)
+		{
+			Vector4 corner((i & 1) ? box.mMax.x : box.mMin.x, (i & 2) ? box.mMax.y : box.mMin.y,
+						   (i & 4) ? box.mMax.z : box.mMin.z, 1.0f);
+			Vector4 clip = Vector4::Transform(corner, viewProj);
+			if (clip.w <= MIN_W)
+			{
+				outRect = ScreenRect();
+				return false;
+			}
+			float x = clip.x / clip.w;
+			float y = clip.y / clip.w;
+			outRect.mMinX = Math::Min(outRect.mMinX, x);
+			outRect.mMinY = Math::Min(outRect.mMinY, y);
+			outRect.mMaxX = Math::Max(outRect.mMaxX, x);
+			outRect.mMaxY = Math::Max(outRect.mMaxY, y);
+		}
+		return true;
+	}
+
+	static constexpr float MIN_W = 0.001f;
+};
+
+// Planes bounding what a view-projection can see, for culling. Each plane keeps
+// the side where dot(plane, (point, 1)) >= 0, same as gl_ClipDistance.
+struct Frustum
+{
+	Frustum() = default;
+
+	// From a (row vector) view-projection. Uses OpenGL's -w <= z <= w depth range,
+	// which is a bit looser than our projections, so nothing GL would draw is culled.
+	explicit Frustum(const Matrix4& viewProj)
+	: Frustum(viewProj, ScreenRect())
+	{
+	}
+
+	// Only what lands inside rect on screen (what a stencil limits a pass to)
+	Frustum(const Matrix4& viewProj, const ScreenRect& rect)
+	{
+		if (rect.IsEmpty())
+		{
+			mIsEmpty = true;
+			return;
+		}
+
+		auto column = [&viewProj](int j) {
+			return Vector4(viewProj.mat[0][j], viewProj.mat[1][j], viewProj.mat[2][j],
+						   viewProj.mat[3][j]);
+		};
+		const Vector4 X = column(0);
+		const Vector4 Y = column(1);
+		const Vector4 Z = column(2);
+		const Vector4 W = column(3);
+
+		// x >= minX * w and so on (minX = -1 gives the usual w + x)
+		auto edge = [&W](const Vector4& v, float sign, float bound) {
+			return Vector4(sign * v.x - bound * W.x, sign * v.y - bound * W.y,
+						   sign * v.z - bound * W.z, sign * v.w - bound * W.w);
+		};
+		AddPlane(edge(X, 1.0f, rect.mMinX));  // Left
+		AddPlane(edge(X, -1.0f, -rect.mMaxX)); // Right
+		AddPlane(edge(Y, 1.0f, rect.mMinY));  // Bottom
+		AddPlane(edge(Y, -1.0f, -rect.mMaxY)); // Top
+		AddPlane(Vector4(W.x + Z.x, W.y + Z.y, W.z + Z.z, W.w + Z.w)); // Near
+		AddPlane(Vector4(W.x - Z.x, W.y - Z.y, W.z - Z.z, W.w - Z.w)); // Far
+	}
+
+	// Also cull anything entirely behind plane (like a portal's clip plane)
+	void AddPlane(const Vector4& plane)
+	{
+		if (mNumPlanes == MAX_PLANES)
+		{
+			return;
+		}
+
+		// Normalized so distances to it are real distances
+		float length = Vector3(plane.x, plane.y, plane.z).Length();
+		if (length > 0.0f)
+		{
+			float invLength = 1.0f / length;
+			mPlanes[mNumPlanes++] = Vector4(plane.x * invLength, plane.y * invLength,
+											plane.z * invLength, plane.w * invLength);
+		}
+	}
+
+	// Returns false only if the sphere is entirely behind one of the planes
+	bool IntersectsSphere(const Vector3& center, float radius) const
+	{
+		if (mIsEmpty)
+		{
+			return false;
+		}
+		for (int i = 0; i < mNumPlanes; i++)
+		{
+			const Vector4& p = mPlanes[i];
+			if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Returns false only if the box is entirely behind one of the planes (tests
+	// the corner furthest along each plane's normal)
+	bool IntersectsBox(const AABB& box) const
+	{
+		if (mIsEmpty)
+		{
+			return false;
+		}
+		for (int i = 0; i < mNumPlanes; i++)
+		{
+			const Vector4& p = mPlanes[i];
+			float x = p.x >= 0.0f ? box.mMax.x : box.mMin.x;
+			float y = p.y >= 0.0f ? box.mMax.y : box.mMin.y;
+			float z = p.z >= 0.0f ? box.mMax.z : box.mMin.z;
+			if (p.x * x + p.y * y + p.z * z + p.w < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// 6 for the view volume plus room for a clip plane
+	static constexpr int MAX_PLANES = 7;
+	Vector4 mPlanes[MAX_PLANES];
+	int mNumPlanes = 0;
+	// Nothing is inside (an empty screen rect)
+	bool mIsEmpty = false;
+};
@@ -0,0 +1,520 @@
+#include "GLRenderBackend.h"
+#include <cstring>
+
+bool GLRenderBackend::Initialize(int width, int height)
+{
+	// Set OpenGL attributes
+#ifndef __EMSCRIPTEN__
+	// Use the core OpenGL profile
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+	// Specify version 3.3
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+#endif
+	// Request a color buffer with 8-bits per RGBA channel
+	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8);
+	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 8);
+	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 8);
+	SDL_GL_SetAttribute(SDL_GL_ALPHA_SIZE, 8);
+	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
+	SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
+	// Enable double buffering
+	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+	// Force OpenGL to use hardware acceleration
+	SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
+
+	mWindow = SDL_CreateWindow("ITP Portal", width, height, SDL_WINDOW_OPENGL);
+	if (!mWindow)
+	{
+		SDL_Log("Failed to create window: %s", SDL_GetError());
+		return false;
+	}
+
+	// Create an OpenGL context
+	mContext = SDL_GL_CreateContext(mWindow);
+	// Turn on vsync
+	SDL_GL_SetSwapInterval(1);
+
+	// Initialize GLEW
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GLEW_OK)
+	{
+		SDL_Log("Failed to initialize GLEW.");
+		return false;
+	}
+
+	// On some platforms, GLEW will emit a benign error code,
+	// so clear it
+	glGetError();
+	return true;
+}
+
+void GLRenderBackend::Shutdown()
+{
+	SDL_GL_DestroyContext(mContext);
+	SDL_DestroyWindow(mWindow);
+	mContext = nullptr;
+	mWindow = nullptr;
+}
+
+SDL_Window* GLRenderBackend::GetWindow() const
+{
+	return mWindow;
+}
+
+void GLRenderBackend::Present()
+{
+	// Swap the buffers
+	SDL_GL_SwapWindow(mWindow);
+	EndFrameCounts();
+}
+
+void GLRenderBackend::SetViewport(int width, int height)
+{
+	mCounts.mStateChanges++;
+	glViewport(0, 0, width, height);
+}
+
+void GLRenderBackend::SetClearColor(float r, float g, float b, float a)
+{
+	glClearColor(r, g, b, a);
+}
+
+void GLRenderBackend::Clear(GLbitfield mask)
+{
+	glClear(mask);
+}
+
+void GLRenderBackend::SetEnabled(GLenum cap, bool enabled)
+{
+	mCounts.mStateChanges++;
+	if (enabled)
+	{
+		glEnable(cap);
+	}
+	else
+	{
+		glDisable(cap);
+	}
+}
+
+void GLRenderBackend::SetDepthMask(bool write)
+{
+	mCounts.mStateChanges++;
+	glDepthMask(write ? GL_TRUE : GL_FALSE);
+}
+
+void GLRenderBackend::SetStencilMask(unsigned int mask)
+{
+	mCounts.mStateChanges++;
+	glStencilMask(mask);
+}
+
+void GLRenderBackend::SetStencilFunc(GLenum func, int ref, unsigned int mask)
+{
+	mCounts.mStateChanges++;
+	glStencilFunc(func, ref, mask);
+}
+
+void GLRenderBackend::SetStencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass)
+{
+	mCounts.mStateChanges++;
+	glStencilOp(stencilFail, depthFail, depthPass);
+}
+
+void GLRenderBackend::SetBlendEquation(GLenum color, GLenum alpha)
+{
+	mCounts.mStateChanges++;
+	glBlendEquationSeparate(color, alpha);
+}
+
+void GLRenderBackend::SetBlendFunc(GLenum srcColor, GLenum dstColor, GLenum srcAlpha,
+								   GLenum dstAlpha)
+{
+	mCounts.mStateChanges++;
+	glBlendFuncSeparate(srcColor, dstColor, srcAlpha, dstAlpha);
+}
+
+void GLRenderBackend::UseProgram(GLuint program)
+{
+	mCounts.mStateChanges++;
+	glUseProgram(program);
+}
+
+void GLRenderBackend::BindVertexArray(GLuint vertexArray)
+{
+	mCounts.mStateChanges++;
+	glBindVertexArray(vertexArray);
+}
+
+void GLRenderBackend::SetActiveTexture(unsigned int unit)
+{
+	mCounts.mStateChanges++;
+	glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLRenderBackend::BindTexture(GLenum target, GLuint texture)
+{
+	mCounts.mStateChanges++;
+	glBindTexture(target, texture);
+}
+
+void GLRenderBackend::DrawIndexed(unsigned int firstIndex, unsigned int numIndices)
+{
+	mCounts.mDrawCalls++;
+	mCounts.mTriangles += numIndices / 3;
+	glDrawElements(GL_TRIANGLES, static_cast<int>(numIndices), GL_UNSIGNED_INT,
+				   reinterpret_cast<void*>(firstIndex * sizeof(GLuint)));
+}
+
+void GLRenderBackend::DrawIndexedInstanced(unsigned int firstIndex, unsigned int numIndices,
+										   int numInstances)
+{
+	mCounts.mDrawCalls++;
+	mCounts.mTriangles += numIndices / 3 * static_cast<unsigned int>(numInstances);
+	glDrawElementsInstanced(GL_TRIANGLES, static_cast<int>(numIndices), GL_UNSIGNED_INT,
+							reinterpret_cast<void*>(firstIndex * sizeof(GLuint)), numInstances);
+}
+
+void GLRenderBackend::SetUniformMatrix4(GLint location, const float* matrix)
+{
+	mCounts.mUniformUploads++;
+	glUniformMatrix4fv(location, 1, GL_TRUE, matrix);
+}
+
+void GLRenderBackend::SetUniformFloats(GLint location, int numFloats, const float* values)
+{
+	mCounts.mUniformUploads++;
+	switch (numFloats)
+	{
+	case 1:
+		glUniform1fv(location, 1, values);
+		break;
+	case 2:
+		glUniform2fv(location, 1, values);
+		break;
+	case 3:
+		glUniform3fv(location, 1, values);
+		break;
+	default:
+		glUniform4fv(location, 1, values);
+		break;
+	}
+}
+
+void GLRenderBackend::SetUniformInt(GLint location, int value)
+{
+	mCounts.mUniformUploads++;
+	glUniform1i(location, value);
+}
+
+GLuint GLRenderBackend::CreateBuffer()
+{
+	GLuint buffer = 0;
+	glGenBuffers(1, &buffer);
+	return buffer;
+}
+
+void GLRenderBackend::DeleteBuffer(GLuint buffer)
+{
+	glDeleteBuffers(1, &buffer);
+}
+
+void GLRenderBackend::BindBuffer(GLenum target, GLuint buffer)
+{
+	glBindBuffer(target, buffer);
+}
+
+void GLRenderBackend::BufferData(GLenum target, size_t size, const void* data, GLenum usage)
+{
+	glBufferData(target, static_cast<long>(size), data, usage);
+}
+
+void GLRenderBackend::BufferSubData(GLenum target, size_t offset, size_t size, const void* data)
+{
+	glBufferSubData(target, static_cast<long>(offset), static_cast<long>(size), data);
+}
+
+void GLRenderBackend::CopyBuffer(GLuint from, GLuint to, size_t size)
+{
+	glBindBuffer(GL_COPY_READ_BUFFER, from);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, to);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<long>(size));
+}
+
+void GLRenderBackend::BindBufferRange(GLenum target, unsigned int index, GLuint buffer,
+									  size_t offset, size_t size)
+{
+	if (target == GL_UNIFORM_BUFFER)
+	{
+		mCounts.mBlockBinds++;
+	}
+	glBindBufferRange(target, index, buffer, static_cast<long>(offset), static_cast<long>(size));
+}
+
+size_t GLRenderBackend::GetUniformBufferAlignment() const
+{
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	return static_cast<size_t>(alignment > 1 ? alignment : 1);
+}
+
+GLuint GLRenderBackend::CreateVertexArray()
+{
+	GLuint vertexArray = 0;
+	glGenVertexArrays(1, &vertexArray);
+	return vertexArray;
+}
+
+void GLRenderBackend::DeleteVertexArray(GLuint vertexArray)
+{
+	glDeleteVertexArrays(1, &vertexArray);
+}
+
+void GLRenderBackend::EnableVertexAttribute(unsigned int index, int numFloats, int stride,
+											size_t offset, unsigned int divisor)
+{
+	glEnableVertexAttribArray(index);
+	glVertexAttribPointer(index, numFloats, GL_FLOAT, GL_FALSE, stride,
+						  reinterpret_cast<void*>(offset));
+	glVertexAttribDivisor(index, divisor);
+}
+
+void GLRenderBackend::DisableVertexAttribute(unsigned int index)
+{
+	glDisableVertexAttribArray(index);
+}
+
+GLuint GLRenderBackend::CreateTexture()
+{
+	GLuint texture = 0;
+	glGenTextures(1, &texture);
+	return texture;
+}
+
+void GLRenderBackend::DeleteTexture(GLuint texture)
+{
+	glDeleteTextures(1, &texture);
+}
+
+void GLRenderBackend::TexImage2D(GLenum target, GLint internalFormat, int width, int height,
+								 GLenum format, const void* pixels, int rowLength)
+{
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+	glTexImage2D(target, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+}
+
+void GLRenderBackend::TexImage3D(GLenum target, GLint internalFormat, int width, int height,
+								 int depth, GLenum format)
+{
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glTexImage3D(target, 0, internalFormat, width, height, depth, 0, format, GL_UNSIGNED_BYTE,
+				 nullptr);
+}
+
+void GLRenderBackend::TexSubImage3D(GLenum target, int layer, int width, int height,
+									GLenum format, const void* pixels)
+{
+	glTexSubImage3D(target, 0, 0, 0, layer, width, height, 1, format, GL_UNSIGNED_BYTE, pixels);
+}
+
+void GLRenderBackend::SetTextureFilter(GLenum target, GLint minFilter, GLint magFilter)
+{
+	glTexParameteri(target, GL_TEXTURE_MIN_FILTER, minFilter);
+	glTexParameteri(target, GL_TEXTURE_MAG_FILTER, magFilter);
+}
+
+void GLRenderBackend::GenerateMipmap(GLenum target)
+{
+	glGenerateMipmap(target);
+}
+
+GLuint GLRenderBackend::CreateProgram(const std::string& vertSource, const std::string& fragSource,
+									  const std::string& name)
+{
+	// Compile vertex and pixel shaders
+	GLuint vertShader = CompileShader(vertSource, GL_VERTEX_SHADER, name + ".vert");
+	GLuint fragShader = CompileShader(fragSource, GL_FRAGMENT_SHADER, name + ".frag");
+
+	// Now create a shader program that
+	// links together the vertex/frag shaders
+	GLuint program = 0;
+	if (vertShader && fragShader)
+	{
+		program = glCreateProgram();
+		glAttachShader(program, vertShader);
+		glAttachShader(program, fragShader);
+		glLinkProgram(program);
+
+		// Verify that the program linked successfully
+		GLint status = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			char buffer[512] = {};
+			glGetProgramInfoLog(program, 511, nullptr, buffer);
+			SDL_Log("GLSL Link Status:\n%s", buffer);
+			glDeleteProgram(program);
+			program = 0;
+		}
+	}
+
+	// The program keeps what it needs
+	glDeleteShader(vertShader);
+	glDeleteShader(fragShader);
+	return program;
+}
+
+void GLRenderBackend::DeleteProgram(GLuint program)
+{
+	glDeleteProgram(program);
+}
+
+void GLRenderBackend::GetActiveUniforms(GLuint program,
+										std::vector<std::pair<std::string, GLint>>& outUniforms)
+{
+	outUniforms.clear();
+
+	GLint numUniforms = 0;
+	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numUniforms);
+	for (GLint i = 0; i < numUniforms; i++)
+	{
+		char name[256] = {};
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(program, static_cast<GLuint>(i), sizeof(name) - 1, nullptr, &size,
+						   &type, name);
+
+		// Arrays are reported as "name[0]", set as a whole through "name"
+		char* bracket = std::strchr(name, '[');
+		if (bracket)
+		{
+			*bracket = '\0';
+		}
+
+		// Members of uniform blocks don't have a location
+		GLint loc = glGetUniformLocation(program, name);
+		if (loc != -1)
+		{
+			outUniforms.emplace_back(name, loc);
+		}
+	}
+}
+
+void GLRenderBackend::SetUniformBlockBinding(GLuint program, const char* block,
+											 unsigned int binding)
+{
+	GLuint index = glGetUniformBlockIndex(program, block);
+	if (index != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(program, index, binding);
+	}
+}
+
+GLuint GLRenderBackend::CreateQuery()
+{
+	GLuint query = 0;
+	glGenQueries(1, &query);
+	return query;
+}
+
+void GLRenderBackend::DeleteQuery(GLuint query)
+{
+	glDeleteQueries(1, &query);
+}
+
+void GLRenderBackend::BeginQuery(GLuint query)
+{
+	glBeginQuery(GL_ANY_SAMPLES_PASSED, query);
+}
+
+void GLRenderBackend::EndQuery()
+{
+	glEndQuery(GL_ANY_SAMPLES_PASSED);
+}
+
+bool GLRenderBackend::GetQueryResult(GLuint query, bool& outAnySamples)
+{
+	GLuint available = 0;
+	glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+	{
+		return false;
+	}
+	GLuint samples = 0;
+	glGetQueryObjectuiv(query, GL_QUERY_RESULT, &samples);
+	outAnySamples = samples != 0;
+	return true;
+}
+
+void GLRenderBackend::BeginConditionalRender(GLuint query)
+{
+	// WebGL has no conditional rendering
+#ifndef __EMSCRIPTEN__
+	glBeginConditionalRender(query, GL_QUERY_WAIT);
+#endif
+}
+
+void GLRenderBackend::EndConditionalRender()
+{
+#ifndef __EMSCRIPTEN__
+	glEndConditionalRender();
+#endif
+}
+
+GLuint GLRenderBackend::CreateFramebuffer(GLuint colorTexture)
+{
+	GLuint framebuffer = 0;
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	return framebuffer;
+}
+
+void GLRenderBackend::DeleteFramebuffer(GLuint framebuffer)
+{
+	glDeleteFramebuffers(1, &framebuffer);
+}
+
+void GLRenderBackend::BindFramebuffer(GLuint framebuffer)
+{
+	mCounts.mStateChanges++;
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void GLRenderBackend::BlitFromWindow(GLuint framebuffer, int srcWidth, int srcHeight,
+									 int dstWidth, int dstHeight)
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+	glBlitFramebuffer(0, 0, srcWidth, srcHeight, 0, 0, dstWidth, dstHeight, GL_COLOR_BUFFER_BIT,
+					  GL_LINEAR);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+GLuint GLRenderBackend::CompileShader(const std::string& source, GLenum shaderType,
+									  const std::string& fileName)
+{
+	const char* contentsChar = source.c_str();
+
+	// Create a shader of the specified type
+	GLuint shader = glCreateShader(shaderType);
+	// Set the source characters and try to compile
+	glShaderSource(shader, 1, &(contentsChar), nullptr);
+	glCompileShader(shader);
+
+	// Query the compile status
+	GLint status = 0;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (status != GL_TRUE)
+	{
+		char buffer[512] = {};
+		glGetShaderInfoLog(shader, 511, nullptr, buffer);
+		SDL_Log("GLSL Compile Failed:\n%s", buffer);
+		SDL_Log("Failed to compile shader %s", fileName.c_str());
+		glDeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
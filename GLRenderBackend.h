@@ -0,0 +1,92 @@
+#pragma once
+#include "RenderBackend.h"
+
+// Draws with OpenGL 3.3 (WebGL 2 on the web)
+class GLRenderBackend : public RenderBackend
+{
+public:
+	bool Initialize(int width, int height) override;
+	void Shutdown() override;
+	SDL_Window* GetWindow() const override;
+	void Present() override;
+
+	void SetViewport(int width, int height) override;
+	void SetClearColor(float r, float g, float b, float a) override;
+	void Clear(GLbitfield mask) override;
+
+	void SetEnabled(GLenum cap, bool enabled) override;
+	void SetDepthMask(bool write) override;
+	void SetStencilMask(unsigned int mask) override;
+	void SetStencilFunc(GLenum func, int ref, unsigned int mask) override;
+	void SetStencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass) override;
+	void SetBlendEquation(GLenum color, GLenum alpha) override;
+	void SetBlendFunc(GLenum srcColor, GLenum dstColor, GLenum srcAlpha, GLenum dstAlpha) override;
+	void UseProgram(GLuint program) override;
+	void BindVertexArray(GLuint vertexArray) override;
+	void SetActiveTexture(unsigned int unit) override;
+	void BindTexture(GLenum target, GLuint texture) override;
+
+	void DrawIndexed(unsigned int firstIndex, unsigned int numIndices) override;
+	void DrawIndexedInstanced(unsigned int firstIndex, unsigned int numIndices,
+							  int numInstances) override;
+
+	void SetUniformMatrix4(GLint location, const float* matrix) override;
+	void SetUniformFloats(GLint location, int numFloats, const float* values) override;
+	void SetUniformInt(GLint location, int value) override;
+
+	GLuint CreateBuffer() override;
+	void DeleteBuffer(GLuint buffer) override;
+	void BindBuffer(GLenum target, GLuint buffer) override;
+	void BufferData(GLenum target, size_t size, const void* data, GLenum usage) override;
+	void BufferSubData(GLenum target, size_t offset, size_t size, const void* data) override;
+	void CopyBuffer(GLuint from, GLuint to, size_t size) override;
+	void BindBufferRange(GLenum target, unsigned int index, GLuint buffer, size_t offset,
+						 size_t size) override;
+	size_t GetUniformBufferAlignment() const override;
+
+	GLuint CreateVertexArray() override;
+	void DeleteVertexArray(GLuint vertexArray) override;
+	void EnableVertexAttribute(unsigned int index, int numFloats, int stride, size_t offset,
+							   unsigned int divisor) override;
+	void DisableVertexAttribute(unsigned int index) override;
+
+	GLuint CreateTexture() override;
+	void DeleteTexture(GLuint texture) override;
+	void TexImage2D(GLenum target, GLint internalFormat, int width, int height, GLenum format,
+					const void* pixels, int rowLength) override;
+	void TexImage3D(GLenum target, GLint internalFormat, int width, int height, int depth,
+					GLenum format) override;
+	void TexSubImage3D(GLenum target, int layer, int width, int height, GLenum format,
+					   const void* pixels) override;
+	void SetTextureFilter(GLenum target, GLint minFilter, GLint magFilter) override;
+	void GenerateMipmap(GLenum target) override;
+
+	GLuint CreateProgram(const std::string& vertSource, const std::string& fragSource,
+						 const std::string& name) override;
+	void DeleteProgram(GLuint program) override;
+	void GetActiveUniforms(GLuint program, std::vector<std::pair<std::string,
+						   GLint>>& outUniforms) override;
+	void SetUniformBlockBinding(GLuint program, const char* block, unsigned int binding) override;
+
+	GLuint CreateQuery() override;
+	void DeleteQuery(GLuint query) override;
+	void BeginQuery(GLuint query) override;
+	void EndQuery() override;
+	bool GetQueryResult(GLuint query, bool& outAnySamples) override;
+	void BeginConditionalRender(GLuint query) override;
+	void EndConditionalRender() override;
+
+	GLuint CreateFramebuffer(GLuint colorTexture) override;
+	void DeleteFramebuffer(GLuint framebuffer) override;
+	void BindFramebuffer(GLuint framebuffer) override;
+	void BlitFromWindow(GLuint framebuffer, int srcWidth, int srcHeight, int dstWidth,
+						int dstHeight) override;
+
+private:
+	// Compiles one stage of CreateProgram's program (0 if it didn't compile)
+	static GLuint CompileShader(const std::string& source, GLenum shaderType,
+								const std::string& fileName);
+
+	SDL_Window* mWindow = nullptr;
+	SDL_GLContext mContext = nullptr;
+};
@@ -0,0 +1,205 @@
+#include "GLState.h"
+#include "RenderBackend.h"
+
+GLState gGLState;
+
+GLState::GLState()
+{
+	Reset();
+}
+
+void GLState::Reset()
+{
+	for (int& cap : mCaps)
+	{
+		cap = -1;
+	}
+	mDepthMask = -1;
+	mStencilMask.reset();
+	mStencilFunc = UNKNOWN;
+	mStencilRef = 0;
+	mStencilFuncMask = 0;
+	for (GLenum& op : mStencilOps)
+	{
+		op = UNKNOWN;
+	}
+	for (GLenum& equation : mBlendEquations)
+	{
+		equation = UNKNOWN;
+	}
+	for (GLenum& func : mBlendFuncs)
+	{
+		func = UNKNOWN;
+	}
+
+	mProgram = UNKNOWN;
+	mVertexArray = UNKNOWN;
+	mActiveUnit = UNKNOWN;
+	for (TextureBinding& binding : mTextures)
+	{
+		binding = TextureBinding{UNKNOWN, UNKNOWN};
+	}
+}
+
+bool GLState::Update(bool isSame)
+{
+	mStats.mCalls++;
+	if (isSame)
+	{
+		mStats.mFiltered++;
+		return false;
+	}
+	return true;
+}
+
+void GLState::SetEnabled(GLenum cap, bool enabled)
+{
+	int index = 0;
+	while (index < NUM_CAPS && CAPS[index] != cap)
+	{
+		index++;
+	}
+	// Anything else isn't tracked
+	if (index < NUM_CAPS)
+	{
+		if (!Update(mCaps[index] == static_cast<int>(enabled)))
+		{
+			return;
+		}
+		mCaps[index] = enabled;
+	}
+	gRenderBackend->SetEnabled(cap, enabled);
+}
+
+void GLState::SetDepthMask(bool write)
+{
+	if (Update(mDepthMask == static_cast<int>(write)))
+	{
+		mDepthMask = write;
+		gRenderBackend->SetDepthMask(write);
+	}
+}
+
+void GLState::SetStencilMask(unsigned int mask)
+{
+	if (Update(mStencilMask == mask))
+	{
+		mStencilMask = mask;
+		gRenderBackend->SetStencilMask(mask);
+	}
+}
+
+void GLState::SetStencilFunc(GLenum func, int ref, unsigned int mask)
+{
+	if (Update(mStencilFunc == func && mStencilRef == ref && mStencilFuncMask == mask))
+	{
+		mStencilFunc = func;
+		mStencilRef = ref;
+		mStencilFuncMask = mask;
+		gRenderBackend->SetStencilFunc(func, ref, mask);
+	}
+}
+
+void GLState::SetStencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass)
+{
+	if (Update(mStencilOps[0] == stencilFail && mStencilOps[1] == depthFail &&
+			   mStencilOps[2] == depthPass))
+	{
+		mStencilOps[0] = stencilFail;
+		mStencilOps[1] = depthFail;
+		mStencilOps[2] = depthPass;
+		gRenderBackend->SetStencilOp(stencilFail, depthFail, depthPass);
+	}
+}
+
+void GLState::SetBlendEquation(GLenum color, GLenum alpha)
+{
+	if (Update(mBlendEquations[0] == color && mBlendEquations[1] == alpha))
+	{
+		mBlendEquations[0] = color;
+		mBlendEquations[1] = alpha;
+		gRenderBackend->SetBlendEquation(color, alpha);
+	}
+}
+
+void GLState::SetBlendFunc(GLenum srcColor, GLenum dstColor, GLenum srcAlpha, GLenum dstAlpha)
+{
+	if (Update(mBlendFuncs[0] == srcColor && mBlendFuncs[1] == dstColor &&
+			   mBlendFuncs[2] == srcAlpha && mBlendFuncs[3] == dstAlpha))
+	{
+		mBlendFuncs[0] = srcColor;
+		mBlendFuncs[1] = dstColor;
+		mBlendFuncs[2] = srcAlpha;
+		mBlendFuncs[3] = dstAlpha;
+		gRenderBackend->SetBlendFunc(srcColor, dstColor, srcAlpha, dstAlpha);
+	}
+}
+
+void GLState::UseProgram(GLuint program)
+{
+	if (Update(mProgram == program))
+	{
+		mProgram = program;
+		gRenderBackend->UseProgram(program);
+	}
+}
+
+void GLState::BindVertexArray(GLuint vertexArray)
+{
+	if (Update(mVertexArray == vertexArray))
+	{
+		mVertexArray = vertexArray;
+		gRenderBackend->BindVertexArray(vertexArray);
+	}
+}
+
+void GLState::BindTexture(unsigned int unit, GLenum target, GLuint texture)
+{
+	if (unit >= MAX_TEXTURE_UNITS)
+	{
+		mActiveUnit = unit;
+		gRenderBackend->SetActiveTexture(unit);
+		gRenderBackend->BindTexture(target, texture);
+		return;
+	}
+
+	TextureBinding& binding = mTextures[unit];
+	if (!Update(binding.mTarget == target && binding.mTexture == texture))
+	{
+		return;
+	}
+	if (mActiveUnit != unit)
+	{
+		mActiveUnit = unit;
+		gRenderBackend->SetActiveTexture(unit);
+	}
+	binding = TextureBinding{target, texture};
+	gRenderBackend->BindTexture(target, texture);
+}
+
+void GLState::OnProgramDeleted(GLuint program)
+{
+	if (mProgram == program)
+	{
+		mProgram = UNKNOWN;
+	}
+}
+
+void GLState::OnVertexArrayDeleted(GLuint vertexArray)
+{
+	if (mVertexArray == vertexArray)
+	{
+		mVertexArray = UNKNOWN;
+	}
+}
+
+void GLState::OnTextureDeleted(GLuint texture)
+{
+	for (TextureBinding& binding : mTextures)
+	{
+		if (binding.mTexture == texture)
+		{
+			binding = TextureBinding{UNKNOWN, UNKNOWN};
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <GL/glew.h>
+#include <optional>
+
+// Calls the renderer made to change GL state, and how many of them were
+// skipped because nothing would have changed
+struct GLStateStats
+{
+	unsigned int mCalls = 0;
+	unsigned int mFiltered = 0;
+};
+
+// Remembers the GL state that's set while drawing (capabilities, depth/stencil/
+// blend settings, program, vertex array and texture bindings), so setting it
+// to what it already is doesn't reach the backend. Anything that changes this
+// state has to go through here, or the tracked values would be wrong.
+class GLState
+{
+public:
+	GLState();
+
+	// Forget everything, so the next call of each kind goes through
+	void Reset();
+
+	// Only the capabilities in CAPS are tracked
+	void SetEnabled(GLenum cap, bool enabled);
+	void SetDepthMask(bool write);
+	void SetStencilMask(unsigned int mask);
+	void SetStencilFunc(GLenum func, int ref, unsigned int mask);
+	void SetStencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass);
+	// Separate color/alpha (glBlendEquationSeparate/glBlendFuncSeparate)
+	void SetBlendEquation(GLenum color, GLenum alpha);
+	void SetBlendFunc(GLenum srcColor, GLenum dstColor, GLenum srcAlpha, GLenum dstAlpha);
+
+	void UseProgram(GLuint program);
+	void BindVertexArray(GLuint vertexArray);
+	void BindTexture(unsigned int unit, GLenum target, GLuint texture);
+
+	// Deleting an object unbinds it (and frees its name for reuse), so these
+	// must be called when one is deleted
+	void OnProgramDeleted(GLuint program);
+	void OnVertexArrayDeleted(GLuint vertexArray);
+	void OnTextureDeleted(GLuint texture);
+
+	const GLStateStats& GetStats() const { return mStats; }
+	void ResetStats() { mStats = GLStateStats(); }
+
+private:
+	// True (and counts the call) if the tracked value needs to change
+	bool Update(bool isSame);
+
+	static constexpr GLenum CAPS[] = {GL_CULL_FACE, GL_CLIP_DISTANCE0, GL_STENCIL_TEST,
+									  GL_DEPTH_TEST, GL_BLEND};
+	static constexpr int NUM_CAPS = sizeof(CAPS) / sizeof(CAPS[0]);
+	static constexpr unsigned int MAX_TEXTURE_UNITS = 4;
+	// Nothing is bound as this (and it isn't an enum), so it never matches
+	static constexpr GLuint UNKNOWN = ~0u;
+
+	// -1 is unknown
+	int mCaps[NUM_CAPS];
+	int mDepthMask;
+	// Any mask is valid (~0u is GL's default), so unknown is empty
+	std::optional<GLuint> mStencilMask;
+	// Ref and mask only count once the func is known
+	GLenum mStencilFunc;
+	int mStencilRef;
+	GLuint mStencilFuncMask;
+	GLenum mStencilOps[3];
+	GLenum mBlendEquations[2];
+	GLenum mBlendFuncs[4];
+
+	GLuint mProgram;
+	GLuint mVertexArray;
+	GLuint mActiveUnit;
+	struct TextureBinding
+	{
+		GLenum mTarget;
+		GLuint mTexture;
+	};
+	TextureBinding mTextures[MAX_TEXTURE_UNITS];
+
+	GLStateStats mStats;
+};
+
+extern GLState gGLState;
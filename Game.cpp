@@ -6,14 +6,24 @@
 #include "InputReplay.h"
 #include "LevelLoader.h"
 #include "Random.h"
+#include "CollisionWorld.h"
+#include "CollisionComponent.h"
+#include "LaserComponent.h"
+#include "PortalSystem.h"
+#include "PhysicsWorld.h"
 #include <SDL3_ttf/SDL_ttf.h>
 
 Game gGame;
 
-bool Game::Initialize()
+bool Game::Initialize(RenderBackendType backendType)
 {
 	// Request 60 FPS
 	SDL_SetHint("SDL_MAIN_CALLBACK_RATE", "60");
+	// Nothing is shown without GL, so it doesn't need a display either
+	if (backendType == RenderBackendType::Null)
+	{
+		SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+	}
 
 	if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO))
 	{
@@ -21,7 +31,7 @@ bool Game::Initialize()
 		return false;
 	}
 
-	mRenderer = new Renderer(this);
+	mRenderer = new Renderer(this, backendType);
 	if (!mRenderer->Initialize(WINDOW_WIDTH, WINDOW_HEIGHT))
 	{
 		SDL_Log("Failed to start renderer");
@@ -33,6 +43,9 @@ bool Game::Initialize()
 
 	Random::Init();
 	mInputReplay = new InputReplay(this);
+	mCollisionWorld = new CollisionWorld();
+	mPortalSystem = new PortalSystem();
+	mPhysicsWorld = new PhysicsWorld();
 
 	LoadData();
 	mTicksCount = SDL_GetTicks();
@@ -56,17 +69,53 @@ bool Game::RunIteration()
 	UpdateGame();
 	GenerateOutput();
 
+	mNumFrames++;
+	if (mFrameLimit > 0 && mNumFrames >= mFrameLimit)
+	{
+		mIsRunning = false;
+	}
 	return true;
 }
 
-void Game::AddCollider(Actor* actor)
+void Game::AddCollider(Actor* actor, bool isStatic)
 {
-	mColliders.emplace_back(actor);
+	mCollisionWorld->AddCollider(actor->GetComponent<CollisionComponent>(), isStatic);
 }
 
 void Game::RemoveCollider(Actor* actor)
 {
-	std::erase(mColliders, actor);
+	CollisionComponent* coll = actor->GetComponent<CollisionComponent>();
+	mCollisionWorld->RemoveCollider(coll);
+
+	// Bodies that were resting on it fall
+	if (coll)
+	{
+		mPhysicsWorld->WakeTouching(coll->GetAABB());
+	}
+}
+
+void Game::SetBluePortal(Portal* p)
+{
+	mBluePortal = p;
+	mPortalSystem->InvalidatePortals();
+	mRenderer->InvalidatePortals();
+}
+
+void Game::SetOrangePortal(Portal* p)
+{
+	mOrangePortal = p;
+	mPortalSystem->InvalidatePortals();
+	mRenderer->InvalidatePortals();
+}
+
+void Game::AddLaser(LaserComponent* laser)
+{
+	mLasers.emplace_back(laser);
+}
+
+void Game::RemoveLaser(LaserComponent* laser)
+{
+	std::erase(mLasers, laser);
 }
 
 Door* Game::GetDoor(const std::string& name) const
@@ -149,6 +198,7 @@ void Game::UpdateGame()
 	mPendingCreate.clear();
 
 	mInputReplay->Update(deltaTime);
+	mPortalSystem->Update();
 
 	for (auto actor : mActors)
 		actor->Update(deltaTime);
@@ -157,14 +207,18 @@ void Game::UpdateGame()
 		DestroyActor(actor);
 	mPendingDestroy.clear();
 
+	mPhysicsWorld->Step(deltaTime);
+	LaserComponent::UpdateLasers(mLasers, mLaserQueries);
+	mCollisionWorld->UpdateTriggers();
+
 	// Check if we need to reload/load a level
 	if (!mNextLevel.empty())
 	{
 		// STEP 1: Call UnloadData()
 		UnloadData();
 
-		// STEP 2: Clear collider vector and door map
-		mColliders.clear();
+		// STEP 2: Clear collision world and door map
+		mCollisionWorld->Clear();
 		mDoorsByName.clear();
 
 		// STEP 3: Call StopPlayback() on input replay
@@ -176,6 +230,8 @@ void Game::UpdateGame()
 		// STEP 5: Set both portal pointers to null
 		mBluePortal = nullptr;
 		mOrangePortal = nullptr;
+		mPortalSystem->InvalidatePortals();
+		mRenderer->InvalidatePortals();
 
 		// STEP 6: Set current level string to next level string
 		mCurrentLevel = mNextLevel;
@@ -207,7 +263,10 @@ void Game::LoadData()
 	mRenderer->SetProjectionMatrix(proj);
 	mRenderer->SetViewMatrix(view);
 
-	mCurrentLevel = "Assets/Level01.json";
+	if (mCurrentLevel.empty())
+	{
+		mCurrentLevel = "Assets/Level01.json";
+	}
 	LevelLoader::Load(mCurrentLevel);
 }
 
@@ -235,6 +294,9 @@ void Game::Shutdown()
 
 	UnloadData();
 
+	delete mPhysicsWorld;
+	delete mPortalSystem;
+	delete mCollisionWorld;
 	delete mAudio;
 	mRenderer->Shutdown();
 	delete mRenderer;
@@ -10,11 +10,19 @@ class Player;
 class Portal;
 class Door;
 class EnergyCatcher;
+struct PortalCastQuery;
+enum class RenderBackendType;
 
 class Game
 {
 public:
-	bool Initialize();
+	bool Initialize(RenderBackendType backendType);
+	// Quit after this many frames (0 runs until the player quits), for benchmarks
+	void SetFrameLimit(unsigned int frames) { mFrameLimit = frames; }
+	// Level Initialize loads instead of the first one
+	void SetStartLevel(const std::string& level) { mCurrentLevel = level; }
+	// Plays back the current level's recorded input (what P does)
+	void StartReplay() { mInputReplay->StartPlayback(mCurrentLevel, false); }
 	bool RunIteration();
 	void Shutdown();
 	void HandleEvent(const SDL_Event* event);
@@ -38,15 +46,22 @@ public:
 	Player* GetPlayer() const { return mPlayer; }
 	void SetPlayer(Player* player) { mPlayer = player; }
 
-	void AddCollider(Actor* actor);
+	// Static colliders (blocks, props) must not move once the level is loaded
+	void AddCollider(Actor* actor, bool isStatic = false);
 	void RemoveCollider(Actor* actor);
-	std::vector<Actor*>& GetColliders() { return mColliders; }
+	class CollisionWorld* GetCollisionWorld() const { return mCollisionWorld; }
+
+	// Lasers are cast together after all actors update
+	void AddLaser(class LaserComponent* laser);
+	void RemoveLaser(class LaserComponent* laser);
 
 	class Portal* GetBluePortal() const { return mBluePortal; }
 	class Portal* GetOrangePortal() const { return mOrangePortal; }
 
-	void SetBluePortal(class Portal* p) { mBluePortal = p; }
-	void SetOrangePortal(class Portal* p) { mOrangePortal = p; }
+	void SetBluePortal(class Portal* p);
+	void SetOrangePortal(class Portal* p);
+	class PortalSystem* GetPortalSystem() const { return mPortalSystem; }
+	class PhysicsWorld* GetPhysicsWorld() const { return mPhysicsWorld; }
 
 	Door* GetDoor(const std::string& name) const;
 	void RegisterDoor(const std::string& name, Door* door);
@@ -56,6 +71,9 @@ public:
 	const std::string& GetCurrentLevel() const { return mCurrentLevel; }
 	void SetNextLevel(const std::string& level) { mNextLevel = level; }
 
+	// Every update is this long (physics steps at the same rate)
+	static constexpr float FIXED_DELTA_TIME = 0.016f; // 60 FPS
+
 private:
 	void ProcessInput();
 	void UpdateGame();
@@ -66,7 +84,6 @@ private:
 
 	// TUNABLE CONSTANTS
 	static constexpr int AUDIO_CHANNELS = 32;
-	static constexpr float FIXED_DELTA_TIME = 0.016f; // 60 FPS
 	static constexpr float WINDOW_WIDTH = 1024.0f;
 	static constexpr float WINDOW_HEIGHT = 768.0f;
 
@@ -79,13 +96,20 @@ private:
 	std::vector<Actor*> mActors;
 	std::vector<Actor*> mPendingCreate;
 	std::vector<Actor*> mPendingDestroy;
-	std::vector<Actor*> mColliders;
+	std::vector<class LaserComponent*> mLasers;
+	// Scratch for casting the lasers
+	std::vector<PortalCastQuery> mLaserQueries;
 
 	class Renderer* mRenderer = nullptr;
 	AudioSystem* mAudio = nullptr;
+	class CollisionWorld* mCollisionWorld = nullptr;
+	class PortalSystem* mPortalSystem = nullptr;
+	class PhysicsWorld* mPhysicsWorld = nullptr;
 
 	Uint64 mTicksCount = 0;
 	bool mIsRunning = true;
+	unsigned int mFrameLimit = 0;
+	unsigned int mNumFrames = 0;
 
 	Player* mPlayer = nullptr;
 
@@ -0,0 +1,98 @@
+#include "InstanceBatch.h"
+#include "Actor.h"
+#include "Frustum.h"
+#include "Mesh.h"
+#include "MeshComponent.h"
+#include "Renderer.h"
+#include "RenderBackend.h"
+#include "Texture.h"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cstddef>
+
+InstanceBatch::InstanceBatch(Mesh* mesh)
+: mMesh(mesh)
+{
+	mTextureArray = new Texture();
+	if (!mTextureArray->LoadArray(mesh->GetTextureNames()))
+	{
+		SDL_Log("Couldn't make a texture array for an instanced mesh");
+		delete mTextureArray;
+		mTextureArray = nullptr;
+		return;
+	}
+
+	mInstanceBuffer = gRenderBackend->CreateBuffer();
+}
+
+InstanceBatch::~InstanceBatch()
+{
+	if (mTextureArray)
+	{
+		gRenderBackend->DeleteBuffer(mInstanceBuffer);
+		mTextureArray->Unload();
+		delete mTextureArray;
+	}
+}
+
+void InstanceBatch::AddComp(MeshComponent* mc)
+{
+	mComps.emplace_back(mc);
+}
+
+void InstanceBatch::RemoveComp(const MeshComponent* mc)
+{
+	auto iter = std::ranges::find(mComps, mc);
+	if (iter != mComps.end())
+	{
+		mComps.erase(iter);
+	}
+}
+
+void InstanceBatch::Draw(const Frustum& frustum, CullStats& stats)
+{
+	mInstances.clear();
+	const float MAX_LAYER = static_cast<float>(mTextureArray->GetNumLayers() - 1);
+	for (const MeshComponent* mc : mComps)
+	{
+		stats.mTested++;
+		if (!mc->IsVisible(frustum))
+		{
+			stats.mCulled++;
+			continue;
+		}
+
+		Instance& instance = mInstances.emplace_back();
+		const Matrix4& world = mc->GetOwner()->GetTransform().GetWorldTransform();
+		std::copy_n(&world.mat[0][0], 16, &instance.mWorld[0][0]);
+		instance.mTextureLayer = Math::Min(static_cast<float>(mc->GetTextureIndex()), MAX_LAYER);
+	}
+	if (mInstances.empty())
+	{
+		return;
+	}
+
+	// New storage every pass, so this doesn't wait on the last pass's draw
+	gRenderBackend->BindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+	gRenderBackend->BufferData(GL_ARRAY_BUFFER, mInstances.size() * sizeof(Instance),
+							   mInstances.data(), GL_STREAM_DRAW);
+
+	// The instance attributes go on the mesh buffer's vertex array just for this
+	// draw (other meshes draw with it too)
+	mTextureArray->SetActive();
+	mMesh->SetActive();
+	for (unsigned int row = 0; row < 4; row++)
+	{
+		const size_t OFFSET = offsetof(Instance, mWorld) + row * 4 * sizeof(float);
+		gRenderBackend->EnableVertexAttribute(WORLD_ATTRIBUTE + row, 4, sizeof(Instance), OFFSET, 1);
+	}
+	gRenderBackend->EnableVertexAttribute(LAYER_ATTRIBUTE, 1, sizeof(Instance),
+										  offsetof(Instance, mTextureLayer), 1);
+
+	mMesh->DrawInstanced(static_cast<int>(mInstances.size()));
+
+	for (unsigned int attribute = WORLD_ATTRIBUTE; attribute <= LAYER_ATTRIBUTE; attribute++)
+	{
+		gRenderBackend->DisableVertexAttribute(attribute);
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+
+struct Frustum;
+struct CullStats;
+class MeshComponent;
+
+// Draws all the (opaque) mesh components using one mesh with a single
+// instanced call. Each instance is a world transform plus a layer in a texture
+// array holding every texture of the mesh, so instances can differ in texture.
+class InstanceBatch
+{
+public:
+	explicit InstanceBatch(class Mesh* mesh);
+	~InstanceBatch();
+
+	// False if the mesh's textures couldn't be made into an array
+	bool IsValid() const { return mTextureArray != nullptr; }
+
+	void AddComp(MeshComponent* mc);
+	void RemoveComp(const MeshComponent* mc);
+	const std::vector<MeshComponent*>& GetComps() const { return mComps; }
+
+	// Draws the components inside frustum. The instanced shader must already be
+	// active, with the pass's view-projection and clip plane.
+	void Draw(const Frustum& frustum, CullStats& stats);
+
+private:
+	struct Instance
+	{
+		// Rows of the world transform
+		float mWorld[4][4];
+		float mTextureLayer;
+	};
+
+	// Attribute locations after the mesh's position/normal/tex coords
+	static constexpr unsigned int WORLD_ATTRIBUTE = 3;
+	static constexpr unsigned int LAYER_ATTRIBUTE = 7;
+
+	class Mesh* mMesh;
+	class Texture* mTextureArray = nullptr;
+	unsigned int mInstanceBuffer = 0;
+
+	std::vector<MeshComponent*> mComps;
+	// Rebuilt every pass
+	std::vector<Instance> mInstances;
+};
@@ -7,118 +7,92 @@
 #include "Game.h"
 #include "Renderer.h"
 #include "Mesh.h"
-#include "Shader.h"
 #include "Texture.h"
-#include "VertexArray.h"
 #include "Portal.h"
+#include "PortalSystem.h"
+#include "Shader.h"
+#include "UniformRing.h"
 
 LaserComponent::LaserComponent(class Actor* owner)
 : MeshComponent(owner)
 {
 	// Use the laser mesh
 	SetMesh(gGame.GetRenderer()->GetMesh("Assets/Meshes/Laser.gpmesh"));
+
+	gGame.AddLaser(this);
 }
 
-void LaserComponent::HandleUpdate(float /*deltaTime*/)
+LaserComponent::~LaserComponent()
 {
-	// If disabled, clear the laser vector and prevent creation of line segments
-	if (!mIsEnabled)
-	{
-		mSegments.clear();
-		mLastHitActor = nullptr;
-		return;
-	}
-
-	// 1. Clear out the line segment vector
-	mSegments.clear();
-
-	// Reset last hit each frame
-	mLastHitActor = nullptr;
-	Actor* lastHit = nullptr;
-
-	// FIRST SEGMENT
-	// From owner's position, 350 units along owner's forward
-	Vector3 start = mOwner->GetTransform().GetPosition();
-	Vector3 dir = mOwner->GetTransform().GetForward();
-	Vector3 end = start + dir * 350.0f;
-
-	LineSegment seg(start, end);
-
-	CastInfo info;
-	bool hitSomething = SegmentCast(gGame.GetActors(), seg, info, mIgnoreActor);
-
-	Portal* entryPortal = nullptr;
-	Portal* exitPortal = nullptr;
+	gGame.RemoveLaser(this);
+}
 
-	if (hitSomething)
+void LaserComponent::UpdateLasers(const std::vector<LaserComponent*>& lasers,
+								  std::vector<PortalCastQuery>& queries)
+{
+	// Every enabled laser is cast together, through portals
+	queries.clear();
+	for (LaserComponent* laser : lasers)
 	{
-		// Shorten to collision point
-		seg.mEnd = info.mPoint;
-		lastHit = info.mActor;
-
-		// Check if we hit a portal and both portals exist
-		entryPortal = dynamic_cast<Portal*>(info.mActor);
-		Portal* blue = gGame.GetBluePortal();
-		Portal* orange = gGame.GetOrangePortal();
-
-		if (entryPortal && blue && orange)
+		// If disabled, clear the laser vector and prevent creation of line segments
+		laser->mSegments.clear();
+		laser->mLastHitActor = nullptr;
+		if (laser->mIsEnabled)
 		{
-			if (entryPortal == blue)
-			{
-				exitPortal = orange;
-			}
-			else if (entryPortal == orange)
-			{
-				exitPortal = blue;
-			}
+			queries.emplace_back(laser->GetQuery());
 		}
 	}
+	gGame.GetPortalSystem()->SegmentCastPacket(queries, false);
 
-	// Store the first (possibly shortened) segment
-	mSegments.emplace_back(seg);
-
-	// SECOND SEGMENT (through portal)
-	if (entryPortal && exitPortal)
+	// The queries are in the same order as the enabled lasers
+	size_t i = 0;
+	for (LaserComponent* laser : lasers)
 	{
-		// 1) Transform direction vector of first segment
-		Vector3 segDir = Vector3::Normalize(seg.mEnd - seg.mStart);
-		Vector3 outDir = entryPortal->GetPortalOutVector(segDir, exitPortal, 0.0f);
-		outDir.Normalize();
-
-		// 2) Transform collision point and offset 5.5 units along outDir
-		Vector3 teleportedPoint = entryPortal->GetPortalOutVector(info.mPoint, exitPortal, 1.0f);
-		Vector3 secondStart = teleportedPoint + outDir * 5.5f;
-
-		// 3) Remaining length is 350 minus length of first segment
-		float firstLen = seg.Length();
-		float remaining = 350.0f - firstLen;
-		if (remaining < 0.0f)
+		if (!laser->mIsEnabled)
 		{
-			remaining = 0.0f;
+			continue;
 		}
-
-		Vector3 secondEnd = secondStart + outDir * remaining;
-		LineSegment secondSeg(secondStart, secondEnd);
-
-		// 4) SegmentCast again, but ignore the *exit* portal this time
-		CastInfo info2;
-		if (SegmentCast(gGame.GetActors(), secondSeg, info2, exitPortal))
+		// A laser that ends on a portal hasn't hit anything (portal may be deleted)
+		const PortalCastQuery& query = queries[i++];
+		if (query.mHit && !dynamic_cast<Portal*>(query.mInfo.mActor))
 		{
-			secondSeg.mEnd = info2.mPoint;
-			lastHit = info2.mActor;
+			laser->mLastHitActor = query.mInfo.mActor;
 		}
-
-		mSegments.emplace_back(secondSeg);
 	}
+}
 
-	// Finalize last hit for this frame
-	mLastHitActor = lastHit;
+PortalCastQuery LaserComponent::GetQuery()
+{
+	// From owner's position along owner's forward
+	PortalCastQuery query;
+	query.mStart = mOwner->GetTransform().GetPosition();
+	query.mDir = mOwner->GetTransform().GetForward();
+	query.mLength = LASER_LENGTH;
+	query.mIgnoreActor = mIgnoreActor;
+	query.mMaxPortals = MAX_PORTALS;
+	query.mOutSegments = &mSegments;
+	return query;
+}
 
-	// Safety: if the last hit actor is a portal, clear it out (portal may be deleted)
-	if (dynamic_cast<Portal*>(mLastHitActor))
+void LaserComponent::UpdateWorldBounds()
+{
+	mHasWorldBounds = mMesh && !mSegments.empty();
+	if (!mHasWorldBounds)
 	{
-		mLastHitActor = nullptr;
+		return;
 	}
+
+	mWorldBox = AABB(mSegments[0].mStart, mSegments[0].mStart);
+	for (const LineSegment& segment : mSegments)
+	{
+		mWorldBox.AddPoint(segment.mStart);
+		mWorldBox.AddPoint(segment.mEnd);
+	}
+	// Covers the beam's thickness (the mesh is only stretched along the segment)
+	mWorldBox.Expand(mMesh->GetRadius());
+
+	mWorldCenter = mWorldBox.GetCenter();
+	mWorldRadius = (mWorldBox.mMax - mWorldCenter).Length();
 }
 
 Matrix4 LaserComponent::GetSegmentTransform(const LineSegment& segment) const
@@ -159,16 +133,29 @@ Matrix4 LaserComponent::GetSegmentTransform(const LineSegment& segment) const
 	return matScale * matRot * matTrans;
 }
 
-void LaserComponent::Draw(Shader* shader)
+void LaserComponent::AddDrawData(UniformRing& drawData)
+{
+	// Each segment has its own world transform instead of the owner's, one
+	// after another
+	for (size_t i = 0; i < mSegments.size(); i++)
+	{
+		Matrix4 world = GetSegmentTransform(mSegments[i]);
+		int index = drawData.Add(&world);
+		if (i == 0)
+		{
+			mDrawData = index;
+		}
+	}
+}
+
+void LaserComponent::Draw(Shader* shader, const UniformRing& drawData)
 {
 	// Loop over every line segment and draw the laser mesh for each one
-	for (const LineSegment& segment : mSegments)
+	for (size_t i = 0; i < mSegments.size(); i++)
 	{
 		if (mMesh)
 		{
-			// Use the segment-based world transform instead of the owner's
-			Matrix4 world = GetSegmentTransform(segment);
-			shader->SetMatrixUniform("uWorldTransform", world);
+			shader->SetDrawIndex(drawData.Bind(mDrawData + static_cast<int>(i)));
 
 			// Set the active texture
 			Texture* t = mMesh->GetTexture(mTextureIndex);
@@ -178,12 +165,10 @@ void LaserComponent::Draw(Shader* shader)
 			}
 
 			// Set the mesh's vertex array as active
-			VertexArray* va = mMesh->GetVertexArray();
-			va->SetActive();
+			mMesh->SetActive();
 
 			// Draw
-			glDrawElements(GL_TRIANGLES, static_cast<int>(va->GetNumIndices()), GL_UNSIGNED_INT,
-						   nullptr);
+			mMesh->Draw();
 		}
 	}
 }
@@ -8,17 +8,26 @@
 #include <vector>
 
 class Actor;
+struct PortalCastQuery;
 
 class LaserComponent : public MeshComponent
 {
 protected:
 	LaserComponent(class Actor* owner);
+	~LaserComponent() override;
 	friend class Actor;
 
-	void HandleUpdate(float deltaTime) override;
-	void Draw(class Shader* shader) override;
+	void AddDrawData(class UniformRing& drawData) override;
+	void Draw(class Shader* shader, const class UniformRing& drawData) override;
+	// Bounds cover the segments rather than the owner
+	void UpdateWorldBounds() override;
 
 public:
+	// Casts every enabled laser (through portals), batched into packet casts.
+	// Called by the game once all actors have updated, with its scratch queries.
+	static void UpdateLasers(const std::vector<LaserComponent*>& lasers,
+							 std::vector<PortalCastQuery>& queries);
+
 	// SegmentCast should ignore this actor when casting
 	void SetIgnoreActor(class Actor* actor) { mIgnoreActor = actor; }
 
@@ -30,6 +39,11 @@ public:
 	bool IsEnabled() const { return mIsEnabled; }
 
 private:
+	// Total length of the laser, including any part past a portal
+	static constexpr float LASER_LENGTH = 350.0f;
+	// How many portals the laser can go through
+	static constexpr int MAX_PORTALS = 1;
+
 	std::vector<LineSegment> mSegments;
 	class Actor* mIgnoreActor = nullptr;
 
@@ -39,6 +53,9 @@ private:
 	// Whether the laser is enabled
 	bool mIsEnabled = true;
 
+	// This laser's cast for UpdateLasers (its segments are filled in by the cast)
+	PortalCastQuery GetQuery();
+
 	// Helper: build a world transform for a given line segment
 	Matrix4 GetSegmentTransform(const LineSegment& segment) const;
 };
@@ -15,9 +15,11 @@
 #include "EnergyCube.h"
 #include "MeshComponent.h"
 #include "Game.h"
+#include "CollisionWorld.h"
 #include "Player.h"
 #include "PortalGun.h"
 #include "Prop.h"
+#include "Renderer.h"
 #include "TurretBase.h"
 #include "VOTrigger.h"
 
@@ -47,11 +49,17 @@ void LoadActor(const rapidjson::Value& actorValue, Actor* parent)
 		// Lookup actor type
 		std::string type = actorValue["type"].GetString();
 		Actor* actor = nullptr;
+		// Never moves, so it can be baked into the level's static geometry
+		bool isStatic = false;
+		// If it isn't baked, drawn with every other one of its mesh in one call
+		bool isInstanced = false;
 
 		if (type == "Block")
 		{
 			Block* block = gGame.CreateActor<Block>();
 			actor = block;
+			isStatic = true;
+			isInstanced = true;
 		}
 
 		else if (type == "Player")
@@ -97,6 +105,7 @@ void LoadActor(const rapidjson::Value& actorValue, Actor* parent)
 			{
 				prop->EnableCollision();
 			}
+			isStatic = !hasCollision && !usesAlpha;
 		}
 
 		else if (type == "PortalGun")
@@ -238,6 +247,21 @@ void LoadActor(const rapidjson::Value& actorValue, Actor* parent)
 				}
 			}
 
+			// Children move with their parent, so only top-level actors are baked.
+			// The instance batch is only made for what's left.
+			MeshComponent* mesh = actor->GetComponent<MeshComponent>();
+			if (mesh)
+			{
+				if (isStatic && !parent)
+				{
+					mesh->SetStatic();
+				}
+				else if (isInstanced)
+				{
+					mesh->SetInstanced();
+				}
+			}
+
 			// See if we have any children
 			auto childIter = actorValue.FindMember("children");
 			if (childIter != actorValue.MemberEnd())
@@ -298,6 +322,10 @@ bool LevelLoader::Load(const std::string& fileName)
 		}
 	}
 
+	// Everything is in place now, so build the static collision tree and geometry
+	gGame.GetCollisionWorld()->BuildStaticTree();
+	gGame.GetRenderer()->BuildStaticGeometry();
+
 	return true;
 }
 
@@ -7,17 +7,74 @@
 //
 
 #include "Game.h"
+#include "RenderBackend.h"
+#include "Renderer.h"
+#include <cstdlib>
+#include <cstring>
 #define SDL_MAIN_USE_CALLBACKS
 #include <SDL3/SDL_main.h>
 
 SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv)
 {
-	return gGame.Initialize() ? SDL_APP_CONTINUE : SDL_APP_FAILURE;
+	// --null-renderer runs without drawing anything (see NullRenderBackend), and
+	// --frames N quits after N frames. The renderer logs what it did on shutdown.
+	// --level FILE starts on another level, and --replay plays its recorded input.
+	// --max-draws, --max-passes and --max-block-binds N fail the run if any frame
+	// asks for more (see RenderBudget).
+	RenderBackendType backendType = RenderBackendType::GL;
+	RenderBudget budget;
+	bool replay = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--null-renderer") == 0)
+		{
+			backendType = RenderBackendType::Null;
+		}
+		else if (std::strcmp(argv[i], "--replay") == 0)
+		{
+			replay = true;
+		}
+		else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+		{
+			gGame.SetStartLevel(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+		{
+			gGame.SetFrameLimit(static_cast<unsigned int>(std::atoi(argv[++i])));
+		}
+		else if (std::strcmp(argv[i], "--max-draws") == 0 && i + 1 < argc)
+		{
+			budget.mDrawCalls = static_cast<unsigned int>(std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--max-passes") == 0 && i + 1 < argc)
+		{
+			budget.mPortalPasses = static_cast<unsigned int>(std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--max-block-binds") == 0 && i + 1 < argc)
+		{
+			budget.mBlockBinds = static_cast<unsigned int>(std::atoi(argv[++i]));
+		}
+	}
+	if (!gGame.Initialize(backendType))
+	{
+		return SDL_APP_FAILURE;
+	}
+
+	gGame.GetRenderer()->SetBudget(budget);
+	if (replay)
+	{
+		gGame.StartReplay();
+	}
+	return SDL_APP_CONTINUE;
 }
 
 SDL_AppResult SDL_AppIterate(void* appstate)
 {
-	return gGame.RunIteration() ? SDL_APP_CONTINUE : SDL_APP_SUCCESS;
+	if (gGame.RunIteration())
+	{
+		return SDL_APP_CONTINUE;
+	}
+	return gGame.GetRenderer()->IsOverBudget() ? SDL_APP_FAILURE : SDL_APP_SUCCESS;
 }
 
 SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event)
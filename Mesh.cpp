@@ -1,15 +1,15 @@
 #include "Mesh.h"
 #include "Renderer.h"
 #include "Texture.h"
-#include "VertexArray.h"
 #include <fstream>
 #include <sstream>
+#include <utility>
 #include <rapidjson/document.h>
 #include <SDL3/SDL_log.h>
 #include "Math.h"
 
 Mesh::Mesh()
-: mVertexArray(nullptr)
+: mBuffer(nullptr)
 , mRadius(0.0f)
 {
 }
@@ -67,9 +67,11 @@ bool Mesh::Load(const std::string& fileName, Renderer* renderer)
 		if (t == nullptr)
 		{
 			// If it's null, use the default texture
-			t = renderer->GetTexture("Assets/Textures/Default.png");
+			texName = "Assets/Textures/Default.png";
+			t = renderer->GetTexture(texName);
 		}
 		mTextures.emplace_back(t);
+		mTextureNames.emplace_back(texName);
 	}
 
 	// Load in the vertices
@@ -154,17 +156,22 @@ bool Mesh::Load(const std::string& fileName, Renderer* renderer)
 		indices.emplace_back(ind[2].GetUint());
 	}
 
-	// Now create a vertex array
-	mVertexArray = new VertexArray(
-		vertices.data(), static_cast<unsigned>(vertices.size()) / static_cast<unsigned>(vertSize),
-		indices.data(), static_cast<unsigned>(indices.size()));
+	// Now add it to the shared mesh buffer
+	mBuffer = renderer->GetMeshBuffer();
+	mRange = mBuffer->Add(vertices, indices);
+
+	// Kept for baking static geometry
+	mVertices = std::move(vertices);
+	mIndices = std::move(indices);
 	return true;
 }
 
 void Mesh::Unload()
 {
-	delete mVertexArray;
-	mVertexArray = nullptr;
+	// Its range of the mesh buffer isn't reused (meshes only unload at shutdown)
+	mBuffer = nullptr;
+	mVertices.clear();
+	mIndices.clear();
 }
 
 Texture* Mesh::GetTexture(size_t index) const
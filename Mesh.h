@@ -3,6 +3,7 @@
 #include <array>
 #include <string>
 #include "Math.h"
+#include "MeshBuffer.h"
 
 class Mesh
 {
@@ -11,10 +12,21 @@ public:
 	// Load/unload mesh
 	bool Load(const std::string& fileName, class Renderer* renderer);
 	void Unload();
-	// Get the vertex array associated with this mesh
-	class VertexArray* GetVertexArray() const { return mVertexArray; }
+	// Make the (shared) vertex array active, then draw
+	void SetActive() const { mBuffer->SetActive(); }
+	void Draw() const { MeshBuffer::Draw(mRange); }
+	void DrawInstanced(int numInstances) const { MeshBuffer::DrawInstanced(mRange, numInstances); }
+	unsigned int GetNumIndices() const { return mRange.mNumIndices; }
+	// Unique per mesh, for sorting draws by mesh
+	unsigned int GetID() const { return mRange.mID; }
 	// Get a texture from specified index
 	class Texture* GetTexture(size_t index) const;
+	// Files the textures came from (same order)
+	const std::vector<std::string>& GetTextureNames() const { return mTextureNames; }
+	// CPU copies of what's in the vertex array (8 floats per vertex: position,
+	// normal, tex coords)
+	const std::vector<float>& GetVertices() const { return mVertices; }
+	const std::vector<unsigned int>& GetIndices() const { return mIndices; }
 	// Get name of shader
 	const std::string& GetShaderName() const { return mShaderName; }
 	// Get object space bounding sphere radius
@@ -33,8 +45,12 @@ private:
 	std::array<Vector3, 8> mBounds;
 	// Textures associated with this mesh
 	std::vector<class Texture*> mTextures;
-	// Vertex array associated with this mesh
-	class VertexArray* mVertexArray;
+	std::vector<std::string> mTextureNames;
+	// Where this mesh is in the renderer's mesh buffer
+	MeshBuffer* mBuffer;
+	MeshBuffer::Range mRange;
+	std::vector<float> mVertices;
+	std::vector<unsigned int> mIndices;
 	// Name of shader specified by mesh
 	std::string mShaderName;
 	// Stores object space bounding sphere radius
@@ -0,0 +1,111 @@
+#include "MeshBuffer.h"
+#include "VertexArray.h"
+#include "GLState.h"
+#include "RenderBackend.h"
+#include <algorithm>
+
+MeshBuffer::MeshBuffer()
+: mVertCapacity(INITIAL_VERTS)
+, mIndexCapacity(INITIAL_INDICES)
+{
+	// Index buffers are only ever bound with this vertex array active (WebGL
+	// doesn't allow binding them as anything else)
+	mVertexArray = gRenderBackend->CreateVertexArray();
+	gGLState.BindVertexArray(mVertexArray);
+
+	mVertexBuffer = gRenderBackend->CreateBuffer();
+	gRenderBackend->BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+	gRenderBackend->BufferData(GL_ARRAY_BUFFER, mVertCapacity * VERTEX_SIZE, nullptr,
+							   GL_STATIC_DRAW);
+
+	mIndexBuffer = gRenderBackend->CreateBuffer();
+	gRenderBackend->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+	gRenderBackend->BufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexCapacity * sizeof(GLuint), nullptr,
+							   GL_STATIC_DRAW);
+
+	VertexArray::SetVertexAttributes();
+	gGLState.BindVertexArray(0);
+}
+
+MeshBuffer::~MeshBuffer()
+{
+	gRenderBackend->DeleteBuffer(mVertexBuffer);
+	gRenderBackend->DeleteBuffer(mIndexBuffer);
+	gRenderBackend->DeleteVertexArray(mVertexArray);
+	gGLState.OnVertexArrayDeleted(mVertexArray);
+}
+
+MeshBuffer::Range MeshBuffer::Add(const std::vector<float>& verts,
+								  const std::vector<unsigned int>& indices)
+{
+	const size_t NUM_VERTS = verts.size() / 8;
+
+	gGLState.BindVertexArray(mVertexArray);
+
+	// Double until it fits (meshes only load with levels, so this is rare)
+	if (mNumVerts + NUM_VERTS > mVertCapacity)
+	{
+		size_t capacity = std::max(mVertCapacity * 2, mNumVerts + NUM_VERTS);
+		Grow(GL_ARRAY_BUFFER, mVertexBuffer, mNumVerts * VERTEX_SIZE, capacity * VERTEX_SIZE);
+		mVertCapacity = capacity;
+		// Attributes point at the buffer that was bound when they were set
+		VertexArray::SetVertexAttributes();
+	}
+	if (mNumIndices + indices.size() > mIndexCapacity)
+	{
+		size_t capacity = std::max(mIndexCapacity * 2, mNumIndices + indices.size());
+		Grow(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer, mNumIndices * sizeof(GLuint),
+			 capacity * sizeof(GLuint));
+		mIndexCapacity = capacity;
+	}
+
+	gRenderBackend->BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+	gRenderBackend->BufferSubData(GL_ARRAY_BUFFER, mNumVerts * VERTEX_SIZE, NUM_VERTS * VERTEX_SIZE,
+								  verts.data());
+
+	std::vector<unsigned int> offsetIndices(indices.size());
+	std::ranges::transform(indices, offsetIndices.begin(), [this](unsigned int index) {
+		return index + static_cast<unsigned int>(mNumVerts);
+	});
+	gRenderBackend->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+	gRenderBackend->BufferSubData(GL_ELEMENT_ARRAY_BUFFER, mNumIndices * sizeof(GLuint),
+								  offsetIndices.size() * sizeof(GLuint), offsetIndices.data());
+	gGLState.BindVertexArray(0);
+
+	Range range;
+	range.mFirstIndex = static_cast<unsigned int>(mNumIndices);
+	range.mNumIndices = static_cast<unsigned int>(indices.size());
+	range.mID = mNumRanges++;
+
+	mNumVerts += NUM_VERTS;
+	mNumIndices += indices.size();
+	return range;
+}
+
+void MeshBuffer::SetActive() const
+{
+	gGLState.BindVertexArray(mVertexArray);
+}
+
+void MeshBuffer::Draw(const Range& range)
+{
+	gRenderBackend->DrawIndexed(range.mFirstIndex, range.mNumIndices);
+}
+
+void MeshBuffer::DrawInstanced(const Range& range, int numInstances)
+{
+	gRenderBackend->DrawIndexedInstanced(range.mFirstIndex, range.mNumIndices, numInstances);
+}
+
+void MeshBuffer::Grow(unsigned int target, unsigned int& buffer, size_t usedBytes,
+					  size_t capacity)
+{
+	unsigned int newBuffer = gRenderBackend->CreateBuffer();
+	gRenderBackend->BindBuffer(target, newBuffer);
+	gRenderBackend->BufferData(target, capacity, nullptr, GL_STATIC_DRAW);
+
+	gRenderBackend->CopyBuffer(buffer, newBuffer, usedBytes);
+
+	gRenderBackend->DeleteBuffer(buffer);
+	buffer = newBuffer;
+}
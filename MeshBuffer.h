@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Vertex and index buffers shared by every Mesh (they all use the same
+// position/normal/tex coords format), with one vertex array over them. Each
+// mesh is a range of the index buffer, so switching meshes is just a different
+// offset. Indices are stored already offset by where the mesh's vertices
+// start, since WebGL 2 has no base vertex draws.
+class MeshBuffer
+{
+public:
+	struct Range
+	{
+		unsigned int mFirstIndex = 0;
+		unsigned int mNumIndices = 0;
+		// Order the range was added in, for sorting by mesh
+		unsigned int mID = 0;
+	};
+
+	MeshBuffer();
+	~MeshBuffer();
+
+	// verts has 8 floats per vertex. Grows the buffers if they're full.
+	Range Add(const std::vector<float>& verts, const std::vector<unsigned int>& indices);
+
+	void SetActive() const;
+	// With the vertex array active
+	static void Draw(const Range& range);
+	static void DrawInstanced(const Range& range, int numInstances);
+
+private:
+	// Moves a buffer's contents into a new one with room for capacity bytes,
+	// leaving it bound to target (with the vertex array active)
+	static void Grow(unsigned int target, unsigned int& buffer, size_t usedBytes,
+					 size_t capacity);
+
+	static constexpr size_t VERTEX_SIZE = 8 * sizeof(float);
+	// Enough for a typical level's meshes without growing
+	static constexpr size_t INITIAL_VERTS = 64 * 1024;
+	static constexpr size_t INITIAL_INDICES = 192 * 1024;
+
+	unsigned int mVertexBuffer = 0;
+	unsigned int mIndexBuffer = 0;
+	unsigned int mVertexArray = 0;
+
+	size_t mNumVerts = 0;
+	size_t mNumIndices = 0;
+	size_t mVertCapacity = 0;
+	size_t mIndexCapacity = 0;
+	unsigned int mNumRanges = 0;
+};
@@ -1,11 +1,12 @@
 #include "MeshComponent.h"
-#include "Shader.h"
 #include "Mesh.h"
 #include "Actor.h"
 #include "Game.h"
 #include "Renderer.h"
 #include "Texture.h"
-#include "VertexArray.h"
+#include "Frustum.h"
+#include "Shader.h"
+#include "UniformRing.h"
 
 MeshComponent::MeshComponent(Actor* owner, bool usesAlpha)
 : Component(owner)
@@ -18,15 +19,68 @@ MeshComponent::MeshComponent(Actor* owner, bool usesAlpha)
 
 MeshComponent::~MeshComponent()
 {
-	gGame.GetRenderer()->RemoveMeshComp(this, mUsesAlpha);
+	switch (mDrawPath)
+	{
+	case DrawPath::Instanced:
+		gGame.GetRenderer()->RemoveInstancedMeshComp(this);
+		break;
+	case DrawPath::Static:
+		gGame.GetRenderer()->RemoveStaticMeshComp(this);
+		break;
+	case DrawPath::Portal:
+		gGame.GetRenderer()->RemovePortalMeshComp(this);
+		break;
+	default:
+		gGame.GetRenderer()->RemoveMeshComp(this, mUsesAlpha);
+		break;
+	}
+}
+
+void MeshComponent::SetInstanced()
+{
+	if (mDrawPath != DrawPath::Normal || mUsesAlpha || !mMesh)
+	{
+		return;
+	}
+
+	// Stays a normal mesh component if the renderer can't batch this mesh
+	if (gGame.GetRenderer()->AddInstancedMeshComp(this))
+	{
+		gGame.GetRenderer()->RemoveMeshComp(this, mUsesAlpha);
+		mDrawPath = DrawPath::Instanced;
+	}
+}
+
+void MeshComponent::SetStatic()
+{
+	if (mDrawPath == DrawPath::Static || mUsesAlpha || !mMesh)
+	{
+		return;
+	}
+
+	if (mDrawPath == DrawPath::Instanced)
+	{
+		gGame.GetRenderer()->RemoveInstancedMeshComp(this);
+	}
+	else
+	{
+		gGame.GetRenderer()->RemoveMeshComp(this, mUsesAlpha);
+	}
+	gGame.GetRenderer()->AddStaticMeshComp(this);
+	mDrawPath = DrawPath::Static;
+}
+
+void MeshComponent::AddDrawData(UniformRing& drawData)
+{
+	mDrawData = drawData.Add(&mOwner->GetTransform().GetWorldTransform());
 }
 
-void MeshComponent::Draw(Shader* shader)
+void MeshComponent::Draw(Shader* shader, const UniformRing& drawData)
 {
 	if (mMesh)
 	{
 		// Set the world transform
-		shader->SetMatrixUniform("uWorldTransform", mOwner->GetTransform().GetWorldTransform());
+		shader->SetDrawIndex(drawData.Bind(mDrawData));
 		// Set the active texture
 		Texture* t = mMesh->GetTexture(mTextureIndex);
 		if (t)
@@ -34,10 +88,44 @@ void MeshComponent::Draw(Shader* shader)
 			t->SetActive();
 		}
 		// Set the mesh's vertex array as active
-		VertexArray* va = mMesh->GetVertexArray();
-		va->SetActive();
+		mMesh->SetActive();
 		// Draw
-		glDrawElements(GL_TRIANGLES, static_cast<int>(va->GetNumIndices()), GL_UNSIGNED_INT,
-					   nullptr);
+		mMesh->Draw();
+	}
+}
+
+Texture* MeshComponent::GetTexture() const
+{
+	return mMesh ? mMesh->GetTexture(mTextureIndex) : nullptr;
+}
+
+void MeshComponent::UpdateWorldBounds()
+{
+	mHasWorldBounds = mMesh != nullptr;
+	if (!mHasWorldBounds)
+	{
+		return;
+	}
+
+	// Sphere around the world origin of the mesh, scaled by the largest axis
+	const Matrix4& world = mOwner->GetTransform().GetWorldTransform();
+	Vector3 scale = world.GetScale();
+	mWorldCenter = world.GetTranslation();
+	mWorldRadius = mMesh->GetRadius() * Math::Max(scale.x, Math::Max(scale.y, scale.z));
+
+	// Box around the transformed corners of the object-space bounds
+	const auto& bounds = mMesh->GetBounds();
+	Vector3 corner = Vector3::Transform(bounds[0], world);
+	mWorldBox = AABB(corner, corner);
+	for (size_t i = 1; i < bounds.size(); i++)
+	{
+		mWorldBox.AddPoint(Vector3::Transform(bounds[i], world));
 	}
 }
+
+bool MeshComponent::IsVisible(const Frustum& frustum) const
+{
+	// The sphere is the cheap test, the box is tighter
+	return mHasWorldBounds && frustum.IntersectsSphere(mWorldCenter, mWorldRadius) &&
+		   frustum.IntersectsBox(mWorldBox);
+}
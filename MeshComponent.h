@@ -1,7 +1,10 @@
 #pragma once
 #include "Component.h"
+#include "AABB.h"
 #include <cstddef>
 
+struct Frustum;
+
 class MeshComponent : public Component
 {
 protected:
@@ -10,14 +13,53 @@ protected:
 
 public:
 	~MeshComponent() override;
-	// Draw this mesh component
-	virtual void Draw(class Shader* shader);
+	// Stages this component's per-draw data (its world transform) for the pass
+	// about to draw it
+	virtual void AddDrawData(class UniformRing& drawData);
+	// Draw this mesh component (after drawData is uploaded)
+	virtual void Draw(class Shader* shader, const class UniformRing& drawData);
 	// Set the mesh/texture index used by mesh component
 	void SetMesh(class Mesh* mesh) { mMesh = mesh; }
 	void SetTextureIndex(size_t index) { mTextureIndex = index; }
+	size_t GetTextureIndex() const { return mTextureIndex; }
+	// Draw with every other instanced component using the same mesh, in one call.
+	// Only for opaque components, after the mesh is set (and not changed after).
+	void SetInstanced();
+	// Bake into the level's static geometry. Same rules as SetInstanced, and the
+	// owner must never move after the level is loaded.
+	void SetStatic();
+	class Mesh* GetMesh() const { return mMesh; }
+	// The mesh's texture at the texture index (null if none)
+	class Texture* GetTexture() const;
+
+	// Recompute the world-space bounds used for culling (the renderer calls this
+	// once per frame, before any pass)
+	virtual void UpdateWorldBounds();
+	// False if nothing this draws can be inside frustum
+	bool IsVisible(const Frustum& frustum) const;
+	bool HasWorldBounds() const { return mHasWorldBounds; }
+	const AABB& GetWorldBox() const { return mWorldBox; }
+	const Vector3& GetWorldCenter() const { return mWorldCenter; }
 
 protected:
 	class Mesh* mMesh;
 	size_t mTextureIndex;
 	bool mUsesAlpha;
+	// How the renderer draws this
+	enum class DrawPath
+	{
+		Normal,
+		Instanced,
+		Static,
+		Portal
+	};
+	DrawPath mDrawPath = DrawPath::Normal;
+	// Where AddDrawData put this pass's draw data
+	int mDrawData = 0;
+
+	// World-space bounding sphere and box, only valid with mHasWorldBounds
+	Vector3 mWorldCenter;
+	float mWorldRadius = 0.0f;
+	AABB mWorldBox;
+	bool mHasWorldBounds = false;
 };
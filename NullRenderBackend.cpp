@@ -0,0 +1,327 @@
+#include "NullRenderBackend.h"
+#include <algorithm>
+#include <regex>
+
+bool NullRenderBackend::Initialize(int width, int height)
+{
+	// Still needs a window for input, but it's never shown
+	mWindow = SDL_CreateWindow("ITP Portal", width, height, SDL_WINDOW_HIDDEN);
+	if (!mWindow)
+	{
+		SDL_Log("Failed to create window: %s", SDL_GetError());
+		return false;
+	}
+	return true;
+}
+
+void NullRenderBackend::Shutdown()
+{
+	SDL_DestroyWindow(mWindow);
+	mWindow = nullptr;
+	mProgramUniforms.clear();
+}
+
+SDL_Window* NullRenderBackend::GetWindow() const
+{
+	return mWindow;
+}
+
+void NullRenderBackend::Present()
+{
+	EndFrameCounts();
+}
+
+void NullRenderBackend::SetViewport(int /*width*/, int /*height*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::SetClearColor(float /*r*/, float /*g*/, float /*b*/, float /*a*/)
+{
+}
+
+void NullRenderBackend::Clear(GLbitfield /*mask*/)
+{
+}
+
+void NullRenderBackend::SetEnabled(GLenum /*cap*/, bool /*enabled*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::SetDepthMask(bool /*write*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::SetStencilMask(unsigned int /*mask*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::SetStencilFunc(GLenum /*func*/, int /*ref*/, unsigned int /*mask*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::SetStencilOp(GLenum /*stencilFail*/, GLenum /*depthFail*/,
+									 GLenum /*depthPass*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::SetBlendEquation(GLenum /*color*/, GLenum /*alpha*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::SetBlendFunc(GLenum /*srcColor*/, GLenum /*dstColor*/, GLenum /*srcAlpha*/,
+									 GLenum /*dstAlpha*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::UseProgram(GLuint /*program*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::BindVertexArray(GLuint /*vertexArray*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::SetActiveTexture(unsigned int /*unit*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::BindTexture(GLenum /*target*/, GLuint /*texture*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::DrawIndexed(unsigned int /*firstIndex*/, unsigned int numIndices)
+{
+	mCounts.mDrawCalls++;
+	mCounts.mTriangles += numIndices / 3;
+}
+
+void NullRenderBackend::DrawIndexedInstanced(unsigned int /*firstIndex*/, unsigned int numIndices,
+											 int numInstances)
+{
+	mCounts.mDrawCalls++;
+	mCounts.mTriangles += numIndices / 3 * static_cast<unsigned int>(numInstances);
+}
+
+void NullRenderBackend::SetUniformMatrix4(GLint /*location*/, const float* /*matrix*/)
+{
+	mCounts.mUniformUploads++;
+}
+
+void NullRenderBackend::SetUniformFloats(GLint /*location*/, int /*numFloats*/,
+										 const float* /*values*/)
+{
+	mCounts.mUniformUploads++;
+}
+
+void NullRenderBackend::SetUniformInt(GLint /*location*/, int /*value*/)
+{
+	mCounts.mUniformUploads++;
+}
+
+GLuint NullRenderBackend::CreateBuffer()
+{
+	return NewName();
+}
+
+void NullRenderBackend::DeleteBuffer(GLuint /*buffer*/)
+{
+}
+
+void NullRenderBackend::BindBuffer(GLenum /*target*/, GLuint /*buffer*/)
+{
+}
+
+void NullRenderBackend::BufferData(GLenum /*target*/, size_t /*size*/, const void* /*data*/,
+								   GLenum /*usage*/)
+{
+}
+
+void NullRenderBackend::BufferSubData(GLenum /*target*/, size_t /*offset*/, size_t /*size*/,
+									  const void* /*data*/)
+{
+}
+
+void NullRenderBackend::CopyBuffer(GLuint /*from*/, GLuint /*to*/, size_t /*size*/)
+{
+}
+
+void NullRenderBackend::BindBufferRange(GLenum target, unsigned int /*index*/, GLuint /*buffer*/,
+										size_t /*offset*/, size_t /*size*/)
+{
+	if (target == GL_UNIFORM_BUFFER)
+	{
+		mCounts.mBlockBinds++;
+	}
+}
+
+size_t NullRenderBackend::GetUniformBufferAlignment() const
+{
+	// The most GL allows, so the offsets are valid anywhere
+	return 256;
+}
+
+GLuint NullRenderBackend::CreateVertexArray()
+{
+	return NewName();
+}
+
+void NullRenderBackend::DeleteVertexArray(GLuint /*vertexArray*/)
+{
+}
+
+void NullRenderBackend::EnableVertexAttribute(unsigned int /*index*/, int /*numFloats*/,
+											  int /*stride*/, size_t /*offset*/,
+											  unsigned int /*divisor*/)
+{
+}
+
+void NullRenderBackend::DisableVertexAttribute(unsigned int /*index*/)
+{
+}
+
+GLuint NullRenderBackend::CreateTexture()
+{
+	return NewName();
+}
+
+void NullRenderBackend::DeleteTexture(GLuint /*texture*/)
+{
+}
+
+void NullRenderBackend::TexImage2D(GLenum /*target*/, GLint /*internalFormat*/, int /*width*/,
+								   int /*height*/, GLenum /*format*/, const void* /*pixels*/,
+								   int /*rowLength*/)
+{
+}
+
+void NullRenderBackend::TexImage3D(GLenum /*target*/, GLint /*internalFormat*/, int /*width*/,
+								   int /*height*/, int /*depth*/, GLenum /*format*/)
+{
+}
+
+void NullRenderBackend::TexSubImage3D(GLenum /*target*/, int /*layer*/, int /*width*/,
+									  int /*height*/, GLenum /*format*/, const void* /*pixels*/)
+{
+}
+
+void NullRenderBackend::SetTextureFilter(GLenum /*target*/, GLint /*minFilter*/,
+										 GLint /*magFilter*/)
+{
+}
+
+void NullRenderBackend::GenerateMipmap(GLenum /*target*/)
+{
+}
+
+GLuint NullRenderBackend::CreateProgram(const std::string& vertSource,
+										const std::string& fragSource, const std::string& /*name*/)
+{
+	const GLuint PROGRAM = NewName();
+
+	// Plain uniforms ("uniform vec4 uColor;"), not blocks ("uniform PassData {")
+	static const std::regex UNIFORM_DECL(
+		R"(\buniform\s+(?:(?:lowp|mediump|highp)\s+)?\w+\s+(\w+)\s*(?:\[[^\]]*\])?\s*;)");
+	std::vector<std::pair<std::string, GLint>>& uniforms = mProgramUniforms[PROGRAM];
+	for (const std::string* source : {&vertSource, &fragSource})
+	{
+		for (std::sregex_iterator iter(source->begin(), source->end(), UNIFORM_DECL), end;
+			 iter != end; ++iter)
+		{
+			std::string uniform = (*iter)[1].str();
+			// Both stages can declare the same one
+			if (std::ranges::find(uniforms, uniform, &std::pair<std::string, GLint>::first) ==
+				uniforms.end())
+			{
+				uniforms.emplace_back(uniform, static_cast<GLint>(uniforms.size()));
+			}
+		}
+	}
+	return PROGRAM;
+}
+
+void NullRenderBackend::DeleteProgram(GLuint program)
+{
+	mProgramUniforms.erase(program);
+}
+
+void NullRenderBackend::GetActiveUniforms(GLuint program,
+										  std::vector<std::pair<std::string, GLint>>& outUniforms)
+{
+	auto iter = mProgramUniforms.find(program);
+	if (iter != mProgramUniforms.end())
+	{
+		outUniforms = iter->second;
+	}
+	else
+	{
+		outUniforms.clear();
+	}
+}
+
+void NullRenderBackend::SetUniformBlockBinding(GLuint /*program*/, const char* /*block*/,
+											   unsigned int /*binding*/)
+{
+}
+
+GLuint NullRenderBackend::CreateQuery()
+{
+	return NewName();
+}
+
+void NullRenderBackend::DeleteQuery(GLuint /*query*/)
+{
+}
+
+void NullRenderBackend::BeginQuery(GLuint /*query*/)
+{
+}
+
+void NullRenderBackend::EndQuery()
+{
+}
+
+bool NullRenderBackend::GetQueryResult(GLuint /*query*/, bool& outAnySamples)
+{
+	// Nothing is ever occluded, so every pass the frontend decides on is counted
+	outAnySamples = true;
+	return true;
+}
+
+void NullRenderBackend::BeginConditionalRender(GLuint /*query*/)
+{
+}
+
+void NullRenderBackend::EndConditionalRender()
+{
+}
+
+GLuint NullRenderBackend::CreateFramebuffer(GLuint /*colorTexture*/)
+{
+	return NewName();
+}
+
+void NullRenderBackend::DeleteFramebuffer(GLuint /*framebuffer*/)
+{
+}
+
+void NullRenderBackend::BindFramebuffer(GLuint /*framebuffer*/)
+{
+	mCounts.mStateChanges++;
+}
+
+void NullRenderBackend::BlitFromWindow(GLuint /*framebuffer*/, int /*srcWidth*/, int /*srcHeight*/,
+									   int /*dstWidth*/, int /*dstHeight*/)
+{
+}
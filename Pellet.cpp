@@ -6,12 +6,11 @@
 #include "MeshComponent.h"
 #include "CollisionComponent.h"
 #include "Player.h"
-#include "Portal.h"
-#include "EnergyCatcher.h"
-#include "EnergyCube.h"
-#include "EnergyGlass.h"
 #include "HealthComponent.h"
 #include "Renderer.h"
+#include "CollisionWorld.h"
+#include "PortalSystem.h"
+#include "RigidBodyComponent.h"
 
 Pellet::Pellet()
 {
@@ -23,8 +22,20 @@ Pellet::Pellet()
 	// Collision comp w/ size {25, 25, 25}
 	mColl = CreateComponent<CollisionComponent>();
 	mColl->SetSize(Vector3(25.0f, 25.0f, 25.0f));
+	mColl->SetLayer(CollisionLayer::Pellet);
 
 	// Not a collider, so don't add to Game::mColliders
+
+	// Pellets keep their speed through portals and don't need a cooldown
+	// (mTeleportIgnoreTime already keeps them off portals for a bit)
+	mPortalPolicy.mOnTeleport = [this](const PortalTransfer& transfer) {
+		Transform& xform = GetTransform();
+		xform.SetPosition(transfer.TransformPoint(xform.GetPosition()));
+		mVelocity = transfer.TransformVector(mVelocity);
+
+		// After teleport, ignore portals and colliders
+		mTeleportIgnoreTime = TELEPORT_IGNORE_TIME;
+	};
 }
 
 Pellet::~Pellet() = default;
@@ -43,10 +54,18 @@ void Pellet::HandleUpdate(float deltaTime)
 		}
 	}
 
-	// Move pellet along its velocity
+	// Move pellet along its velocity. Once it can hit colliders, sweep so fast
+	// pellets stop at anything they would otherwise skip past.
+	Vector3 delta = mVelocity * deltaTime;
+	if (mColl && mAge >= SPAWN_IMMUNITY_TIME && mTeleportIgnoreTime <= 0.0f)
+	{
+		Vector3 normal;
+		gGame.GetCollisionWorld()->SweepMove(mColl, delta, normal, false);
+	}
+
 	Transform& xform = GetTransform();
 	Vector3 pos = xform.GetPosition();
-	pos += mVelocity * deltaTime;
+	pos += delta;
 	xform.SetPosition(pos);
 
 	CollisionComponent* self = GetComponent<CollisionComponent>();
@@ -82,7 +101,7 @@ void Pellet::HandleUpdate(float deltaTime)
 	}
 
 	// Pellets teleporting through portals
-	if (TeleportThroughPortals())
+	if (TeleportThroughPortals(deltaTime))
 	{
 		// On the frame we teleport, ignore all other collisions
 		return;
@@ -95,120 +114,70 @@ void Pellet::HandleUpdate(float deltaTime)
 	}
 
 	// After 0.25s, colliding with any collider destroys the pellet,
-	// EXCEPT when hitting an EnergyCatcher that then "catches" it.
-	for (Actor* actor : gGame.GetColliders())
+	// EXCEPT for the energy cubes and catchers it overlaps.
+	gGame.GetCollisionWorld()->QueryOverlaps(self->GetAABB(), mHits, self);
+	for (CollisionComponent* other : mHits)
 	{
-		CollisionComponent* other = actor->GetComponent<CollisionComponent>();
-		if (other && self->Intersect(other))
+		// Knocks resting bodies (cubes, turrets) awake
+		RigidBodyComponent* body = other->GetOwner()->GetComponent<RigidBodyComponent>();
+		if (body)
 		{
-			// Special case: EnergyCatcher
-			if (auto* catcher = dynamic_cast<EnergyCatcher*>(actor))
-			{
-				// Only catch once, if not already activated
-				if (!catcher->IsActivated())
-				{
-					catcher->CatchPellet(this);
-				}
+			body->Wake();
+		}
 
-				// Pellet does NOT die when caught
-				return;
-			}
+		// Energy cubes turn the pellet green, catchers catch it (it doesn't die)
+		if (GetCollisionResponse(self->GetLayer(), other->GetLayer()) == CollisionResponse::Overlap)
+		{
+			other->NotifyOverlap(self);
+			return;
+		}
 
-			// Special case: EnergyCube
-			if (dynamic_cast<EnergyCube*>(actor) != nullptr)
+		// Special case: EnergyGlass
+		if (other->GetLayer() == CollisionLayer::Glass)
+		{
+			// If green, go through (don't die)
+			if (mIsGreen)
 			{
-				// Don't die, turn green
-				mIsGreen = true;
-				if (mMesh)
-				{
-					mMesh->SetTextureIndex(2);
-				}
-				// Continue going through
 				return;
 			}
+			// Otherwise, die
+			gGame.GetAudio()->PlaySound("PelletDeath.ogg", false, this, false);
+			Destroy();
+			return;
+		}
 
-			// Special case: EnergyGlass
-			if (dynamic_cast<EnergyGlass*>(actor) != nullptr)
+		// Check if the collider has a HealthComponent
+		HealthComponent* health = other->GetOwner()->GetComponent<HealthComponent>();
+		if (health)
+		{
+			// If the object is already dead, ignore the collision
+			if (health->IsDead())
 			{
-				// If green, go through (don't die)
-				if (mIsGreen)
-				{
-					return;
-				}
-				// Otherwise, die
-				gGame.GetAudio()->PlaySound("PelletDeath.ogg", false, this, false);
-				Destroy();
 				return;
 			}
 
-			// Check if the collider has a HealthComponent
-			HealthComponent* health = actor->GetComponent<HealthComponent>();
-			if (health)
-			{
-				// If the object is already dead, ignore the collision
-				if (health->IsDead())
-				{
-					return;
-				}
-
-				// Otherwise, deal 100 damage
-				Vector3 pelletPos = GetTransform().GetPosition();
-				health->TakeDamage(100.0f, pelletPos);
-			}
-
-			// Any other collider kills the pellet
-			gGame.GetAudio()->PlaySound("PelletDeath.ogg", false, this, false);
-			Destroy();
-			return;
+			// Otherwise, deal 100 damage
+			Vector3 pelletPos = GetTransform().GetPosition();
+			health->TakeDamage(100.0f, pelletPos);
 		}
+
+		// Any other collider kills the pellet
+		gGame.GetAudio()->PlaySound("PelletDeath.ogg", false, this, false);
+		Destroy();
+		return;
 	}
 }
 
-bool Pellet::TeleportThroughPortals()
+void Pellet::TurnGreen()
 {
-	// Need both portals for teleporting
-	Portal* bluePortal = gGame.GetBluePortal();
-	Portal* orangePortal = gGame.GetOrangePortal();
-	if (!bluePortal || !orangePortal || !mColl)
-	{
-		return false;
-	}
-
-	Portal* entryPortal = nullptr;
-	Portal* exitPortal = nullptr;
-
-	// Check intersection w/ blue portal
-	if (CollisionComponent* blueColl = bluePortal->GetComponent<CollisionComponent>();
-		blueColl && mColl->Intersect(blueColl))
-	{
-		entryPortal = bluePortal;
-		exitPortal = orangePortal;
-	}
-
-	// Check intersection w/ orange portal
-	else if (CollisionComponent* orangeColl = orangePortal->GetComponent<CollisionComponent>();
-			 orangeColl && mColl->Intersect(orangeColl))
-	{
-		entryPortal = orangePortal;
-		exitPortal = bluePortal;
-	}
-
-	if (!entryPortal || !exitPortal)
+	mIsGreen = true;
+	if (mMesh)
 	{
-		return false;
+		mMesh->SetTextureIndex(2);
 	}
+}
 
-	// Transform position through the portals
-	Transform& xform = GetTransform();
-	Vector3 pos = xform.GetPosition();
-	Vector3 newPos = entryPortal->GetPortalOutVector(pos, exitPortal, 1.0f);
-	xform.SetPosition(newPos);
-
-	// Transform velocity through the portals
-	mVelocity = entryPortal->GetPortalOutVector(mVelocity, exitPortal, 0.0f);
-
-	// After teleport, ignore portals and colliders
-	mTeleportIgnoreTime = TELEPORT_IGNORE_TIME;
-
-	return true;
+bool Pellet::TeleportThroughPortals(float deltaTime)
+{
+	return gGame.GetPortalSystem()->TryTeleport(mColl, mPortalPolicy, deltaTime);
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "Actor.h"
+#include "PortalSystem.h"
 
 class MeshComponent;
 class CollisionComponent;
@@ -10,6 +11,9 @@ public:
 	// Called by energy launcher to set initial velocity
 	void SetVelocity(const Vector3& vel) { mVelocity = vel; }
 
+	// Called by energy cubes, lets the pellet go through energy glass
+	void TurnGreen();
+
 protected:
 	Pellet();
 	~Pellet() override;
@@ -19,7 +23,7 @@ protected:
 
 private:
 	// Teleport through portals if intersecting one
-	bool TeleportThroughPortals();
+	bool TeleportThroughPortals(float deltaTime);
 
 	// Tunable gameplay constants
 	static constexpr float SPAWN_IMMUNITY_TIME = 0.25f;
@@ -27,6 +31,9 @@ private:
 
 	MeshComponent* mMesh = nullptr;
 	CollisionComponent* mColl = nullptr;
+	PortalPolicy mPortalPolicy;
+	// Scratch space for the overlap query
+	std::vector<CollisionComponent*> mHits;
 
 	Vector3 mVelocity = Vector3::Zero;
 	float mAge = 0.0f;				  // Tracks lifetime for spawn protection
@@ -0,0 +1,265 @@
+#include "PhysicsWorld.h"
+#include <algorithm>
+#include <numeric>
+#include "Actor.h"
+#include "Game.h"
+#include "CollisionComponent.h"
+#include "CollisionWorld.h"
+#include "PortalSystem.h"
+#include "RigidBodyComponent.h"
+
+namespace
+{
+	// One step per game update, so physics runs at whatever rate the game does
+	constexpr float FIXED_STEP = Game::FIXED_DELTA_TIME;
+
+	// Outward normal of the side of a collider that was hit
+	Vector3 GetSideNormal(CollSide side)
+	{
+		switch (side)
+		{
+		case CollSide::Top:
+			return Vector3::UnitZ;
+		case CollSide::Bottom:
+			return Vector3::UnitZ * -1.0f;
+		case CollSide::Front:
+			return Vector3::UnitX;
+		case CollSide::Back:
+			return Vector3::UnitX * -1.0f;
+		case CollSide::Right:
+			return Vector3::UnitY;
+		case CollSide::Left:
+			return Vector3::UnitY * -1.0f;
+		default:
+			return Vector3::Zero;
+		}
+	}
+} // namespace
+
+void PhysicsWorld::Step(float deltaTime)
+{
+	mAccumulator += deltaTime;
+	int numSteps = 0;
+	while (mAccumulator >= FIXED_STEP && numSteps < MAX_STEPS_PER_UPDATE)
+	{
+		FixedStep();
+		mAccumulator -= FIXED_STEP;
+		numSteps++;
+	}
+
+	// Drop whatever we couldn't catch up on instead of spiraling
+	mAccumulator = Math::Min(mAccumulator, FIXED_STEP);
+}
+
+void PhysicsWorld::WakeBody(RigidBodyComponent* body)
+{
+	if (!body->mIsInAwakeList)
+	{
+		body->mIsInAwakeList = true;
+		mAwakeBodies.emplace_back(body);
+	}
+}
+
+void PhysicsWorld::RemoveBody(RigidBodyComponent* body)
+{
+	if (body->mIsInAwakeList)
+	{
+		std::erase(mAwakeBodies, body);
+	}
+}
+
+void PhysicsWorld::WakeTouching(const AABB& box)
+{
+	AABB queryBox = box;
+	queryBox.Expand(WAKE_MARGIN);
+	gGame.GetCollisionWorld()->QueryOverlaps(queryBox, mTouching);
+	for (CollisionComponent* coll : mTouching)
+	{
+		RigidBodyComponent* body = coll->GetOwner()->GetComponent<RigidBodyComponent>();
+		// Awake bodies already find out on their own
+		if (body && !body->mIsAwake)
+		{
+			body->Wake();
+		}
+	}
+}
+
+void PhysicsWorld::FixedStep()
+{
+	// Bodies woken during the step (by being touched) start moving next step
+	const int NUM_BODIES = static_cast<int>(mAwakeBodies.size());
+	mIslandParents.resize(NUM_BODIES);
+	std::iota(mIslandParents.begin(), mIslandParents.end(), 0);
+	for (int i = 0; i < NUM_BODIES; i++)
+	{
+		mAwakeBodies[i]->mStepIndex = i;
+	}
+
+	// Islands only share the broadphase, but that (and the gameplay callbacks
+	// bodies run) isn't thread safe, so they're stepped one after another
+	for (int i = 0; i < NUM_BODIES; i++)
+	{
+		RigidBodyComponent* body = mAwakeBodies[i];
+		if (body->mIsAwake && body->mColl)
+		{
+			// Anything resting on the body has to follow once it moves away
+			AABB oldBox = body->mColl->GetAABB();
+			StepBody(body, i);
+			Vector3 moved = body->mColl->GetAABB().GetCenter() - oldBox.GetCenter();
+			if (moved.LengthSq() > SLEEP_SPEED * FIXED_STEP * SLEEP_SPEED * FIXED_STEP)
+			{
+				WakeTouching(oldBox);
+			}
+		}
+	}
+
+	// An island sleeps once its most recently moving body has been still long enough
+	mIslandRestTimes.assign(NUM_BODIES, SLEEP_TIME);
+	for (int i = 0; i < NUM_BODIES; i++)
+	{
+		const RigidBodyComponent* body = mAwakeBodies[i];
+		if (body->mIsAwake)
+		{
+			float& islandRest = mIslandRestTimes[FindIsland(i)];
+			islandRest = Math::Min(islandRest, body->mRestTime);
+		}
+	}
+	for (int i = 0; i < NUM_BODIES; i++)
+	{
+		RigidBodyComponent* body = mAwakeBodies[i];
+		body->mStepIndex = -1;
+		if (body->mIsAwake && mIslandRestTimes[FindIsland(i)] >= SLEEP_TIME)
+		{
+			body->Sleep();
+		}
+	}
+
+	std::erase_if(mAwakeBodies, [](RigidBodyComponent* body) {
+		if (body->mIsAwake)
+		{
+			return false;
+		}
+		body->mIsInAwakeList = false;
+		return true;
+	});
+}
+
+void PhysicsWorld::StepBody(RigidBodyComponent* body, int index)
+{
+	CollisionComponent* coll = body->mColl;
+	CollisionWorld* world = gGame.GetCollisionWorld();
+	Transform& xform = coll->GetOwner()->GetTransform();
+
+	// Move by the velocity (swept, so a fast body can't pass through thin geometry)
+	Vector3 delta = body->mVelocity * FIXED_STEP;
+	Vector3 normal;
+	if (world->SweepMove(coll, delta, normal))
+	{
+		float intoSurface = Vector3::Dot(body->mVelocity, normal);
+		if (intoSurface < 0.0f)
+		{
+			body->mVelocity -= normal * intoSurface;
+		}
+	}
+	xform.SetPosition(xform.GetPosition() + delta);
+
+	// A body that just came out of a portal is up against the wall behind it,
+	// so skip the rest of the step
+	if (body->mPortalPolicy &&
+		gGame.GetPortalSystem()->TryTeleport(coll, *body->mPortalPolicy, FIXED_STEP))
+	{
+		return;
+	}
+
+	body->mVelocity += GRAVITY * FIXED_STEP;
+
+	AABB queryBox = coll->GetAABB();
+	queryBox.Expand(CONTACT_QUERY_MARGIN);
+	Vector3 pos = world->ResolveContacts(coll, queryBox, mContacts);
+	if (!mContacts.empty())
+	{
+		xform.SetPosition(pos);
+	}
+
+	bool onGround = false;
+	for (const Contact& contact : mContacts)
+	{
+		if (body->mOnContact)
+		{
+			body->mOnContact(contact);
+		}
+		// The callback can put the body to sleep (a turret that landed)
+		if (!body->mIsAwake)
+		{
+			return;
+		}
+
+		// Stop moving into what we were pushed out of (or are resting on)
+		Vector3 contactNormal = GetSideNormal(contact.mSide);
+		float intoSurface = Vector3::Dot(body->mVelocity, contactNormal);
+		if (intoSurface < 0.0f)
+		{
+			body->mVelocity -= contactNormal * intoSurface;
+		}
+		if (contact.mSide == CollSide::Top)
+		{
+			onGround = true;
+		}
+
+		RigidBodyComponent* other = contact.mOther->GetOwner()->GetComponent<RigidBodyComponent>();
+		if (other)
+		{
+			if (!other->mIsAwake)
+			{
+				other->Wake();
+			}
+			else if (other->mStepIndex != -1)
+			{
+				JoinIslands(index, other->mStepIndex);
+			}
+		}
+	}
+
+	// Something pushed along the ground slides to a stop
+	if (onGround)
+	{
+		const float SPEED_KEPT = Math::Max(0.0f, 1.0f - GROUND_FRICTION * FIXED_STEP);
+		body->mVelocity.x *= SPEED_KEPT;
+		body->mVelocity.y *= SPEED_KEPT;
+	}
+
+	if (body->mMaxSpeed > 0.0f && body->mVelocity.LengthSq() > body->mMaxSpeed * body->mMaxSpeed)
+	{
+		body->mVelocity.Normalize();
+		body->mVelocity *= body->mMaxSpeed;
+	}
+
+	if (body->mVelocity.LengthSq() < SLEEP_SPEED * SLEEP_SPEED)
+	{
+		body->mRestTime += FIXED_STEP;
+	}
+	else
+	{
+		body->mRestTime = 0.0f;
+	}
+}
+
+int PhysicsWorld::FindIsland(int index)
+{
+	while (mIslandParents[index] != index)
+	{
+		mIslandParents[index] = mIslandParents[mIslandParents[index]];
+		index = mIslandParents[index];
+	}
+	return index;
+}
+
+void PhysicsWorld::JoinIslands(int a, int b)
+{
+	a = FindIsland(a);
+	b = FindIsland(b);
+	if (a != b)
+	{
+		mIslandParents[std::max(a, b)] = std::min(a, b);
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "Math.h"
+#include "AABB.h"
+#include <vector>
+
+class RigidBodyComponent;
+class CollisionComponent;
+struct Contact;
+
+// Moves every awake RigidBodyComponent in fixed steps: gravity, a sweep
+// against the colliders, portals, then pushing out of whatever it ends up in
+// (through CollisionWorld, so the broadphase only hands back nearby pairs).
+// Bodies that touched each other during a step form an island, and an island
+// falls asleep once all of its bodies have been still for SLEEP_TIME. Sleeping
+// bodies aren't looked at at all; to awake bodies they're just colliders, and
+// touching one wakes it. Bodies also wake when the player pushes them, a pellet
+// hits them, or what they rest on moves away or is removed.
+class PhysicsWorld
+{
+public:
+	// Runs as many fixed steps as deltaTime covers
+	void Step(float deltaTime);
+
+	// Called by RigidBodyComponent (bodies are only destroyed between steps)
+	void WakeBody(RigidBodyComponent* body);
+	void RemoveBody(RigidBodyComponent* body);
+
+	// Wakes the sleeping bodies touching box, for when a collider there moved
+	// away or was removed
+	void WakeTouching(const AABB& box);
+
+	size_t GetNumAwakeBodies() const { return mAwakeBodies.size(); }
+
+private:
+	static constexpr int MAX_STEPS_PER_UPDATE = 4;
+	static constexpr Vector3 GRAVITY = Vector3(0.0f, 0.0f, -980.0f);
+	// Room around a body when gathering colliders, covers the pushes while resolving
+	static constexpr float CONTACT_QUERY_MARGIN = 64.0f;
+	// Slower than this counts as still
+	static constexpr float SLEEP_SPEED = 5.0f;
+	static constexpr float SLEEP_TIME = 0.5f;
+	// Fraction of its sideways speed a body loses per second while resting on something
+	static constexpr float GROUND_FRICTION = 6.0f;
+	// Room around a box when looking for the bodies touching it
+	static constexpr float WAKE_MARGIN = 1.0f;
+
+	void FixedStep();
+	void StepBody(RigidBodyComponent* body, int index);
+
+	// Union-find over the awake bodies of a step
+	int FindIsland(int index);
+	void JoinIslands(int a, int b);
+
+	// In the order they were woken
+	std::vector<RigidBodyComponent*> mAwakeBodies;
+	float mAccumulator = 0.0f;
+
+	std::vector<int> mIslandParents;
+	std::vector<float> mIslandRestTimes;
+	std::vector<Contact> mContacts;
+	std::vector<CollisionComponent*> mTouching;
+};
@@ -29,6 +29,7 @@ Player::Player()
 	mCamera = CreateComponent<CameraComponent>();
 	mColl = CreateComponent<CollisionComponent>();
 	mColl->SetSize({50.0f, 50.0f, 100.0f});
+	mColl->SetLayer(CollisionLayer::Player);
 
 	// Health component so player can be targeted by turrets
 	mHealth = CreateComponent<HealthComponent>();
@@ -14,6 +14,8 @@
 #include "Portal.h"
 #include "HealthComponent.h"
 #include "Math.h"
+#include "CollisionWorld.h"
+#include "RigidBodyComponent.h"
 
 void PlayerMove::ResetMove()
 {
@@ -39,6 +41,12 @@ PlayerMove::PlayerMove(class Actor* owner)
 , mCurrentState(MoveState::OnGround)
 , mPrevState(MoveState::OnGround)
 {
+	// Player teleports with a boost and turns to face out of the exit portal
+	mPortalPolicy.mCooldown = PORTAL_TELEPORT_COOLDOWN;
+	mPortalPolicy.mOnTeleport = [this](const PortalTransfer& transfer) {
+		DoPortalTeleport(transfer);
+	};
+
 	// Create crosshair for player
 	mCrosshair = mOwner->CreateComponent<Crosshair>();
 
@@ -255,16 +263,12 @@ void PlayerMove::UpdateOnGround(float deltaTime)
 	const CollisionComponent* self = mOwner->GetComponent<CollisionComponent>();
 	if (self)
 	{
-		for (Actor* actor : gGame.GetColliders())
+		ResolveCollisions(self, true);
+		for (const Contact& contact : mContacts)
 		{
-			const CollisionComponent* other = actor->GetComponent<CollisionComponent>();
-			if (other)
+			if (contact.mSide == CollSide::Top)
 			{
-				CollSide side = FixCollision(self, other);
-				if (side == CollSide::Top)
-				{
-					onTop = true;
-				}
+				onTop = true;
 			}
 		}
 	}
@@ -290,16 +294,12 @@ void PlayerMove::UpdateJump(float deltaTime)
 	const CollisionComponent* self = mOwner->GetComponent<CollisionComponent>();
 	if (self)
 	{
-		for (Actor* actor : gGame.GetColliders())
+		ResolveCollisions(self, false);
+		for (const Contact& contact : mContacts)
 		{
-			const CollisionComponent* other = actor->GetComponent<CollisionComponent>();
-			if (other)
+			if (contact.mSide == CollSide::Bottom)
 			{
-				CollSide side = FixCollision(self, other);
-				if (side == CollSide::Bottom)
-				{
-					mVelocity.z = 0.0f;
-				}
+				mVelocity.z = 0.0f;
 			}
 		}
 	}
@@ -327,16 +327,12 @@ void PlayerMove::UpdateFalling(float deltaTime)
 	const CollisionComponent* self = mOwner->GetComponent<CollisionComponent>();
 	if (self)
 	{
-		for (Actor* actor : gGame.GetColliders())
+		ResolveCollisions(self, false);
+		for (const Contact& contact : mContacts)
 		{
-			const CollisionComponent* other = actor->GetComponent<CollisionComponent>();
-			if (other)
+			if (contact.mSide == CollSide::Top && mVelocity.z <= 0.0f)
 			{
-				CollSide side = FixCollision(self, other);
-				if (side == CollSide::Top && mVelocity.z <= 0.0f)
-				{
-					landed = true;
-				}
+				landed = true;
 			}
 		}
 	}
@@ -368,9 +364,22 @@ void PlayerMove::PhysicsUpdate(float deltaTime)
 		mVelocity.z = MIN_Z;
 	}
 
-	// Update position
+	// Update position, sweeping so fast moves can't pass through thin geometry
+	Vector3 delta = mVelocity * deltaTime;
+	const CollisionComponent* self = mOwner->GetComponent<CollisionComponent>();
+	Vector3 normal;
+	if (self && gGame.GetCollisionWorld()->SweepMove(self, delta, normal))
+	{
+		// Slide along what we hit
+		float intoSurface = Vector3::Dot(mVelocity, normal);
+		if (intoSurface < 0.0f)
+		{
+			mVelocity -= normal * intoSurface;
+		}
+	}
+
 	Vector3 pos = mOwner->GetTransform().GetPosition();
-	pos += mVelocity * deltaTime;
+	pos += delta;
 	mOwner->GetTransform().SetPosition(pos);
 
 	// Update rotation
@@ -424,18 +433,45 @@ void PlayerMove::FixXYVelocity()
 	mVelocity.y = xyVelocity.y;
 }
 
-CollSide PlayerMove::FixCollision(const CollisionComponent* self,
-								  const CollisionComponent* collider) const
+void PlayerMove::ResolveCollisions(const CollisionComponent* self, bool useContactCache)
 {
-	Vector3 offset;
-	CollSide side = self->GetMinOverlap(collider, offset);
-	if (side != CollSide::None)
+	CollisionWorld* world = gGame.GetCollisionWorld();
+	Vector3 pos;
+	if (useContactCache)
+	{
+		pos = world->ResolveContactsCached(self, COLLISION_QUERY_MARGIN, mGroundContacts, mContacts);
+	}
+	else
+	{
+		AABB box = self->GetAABB();
+		box.Expand(COLLISION_QUERY_MARGIN);
+		pos = world->ResolveContacts(self, box, mContacts);
+	}
+	if (!mContacts.empty())
 	{
-		Vector3 pos = mOwner->GetTransform().GetPosition();
-		pos += offset;
 		mOwner->GetTransform().SetPosition(pos);
 	}
-	return side;
+
+	// Shove the bodies we walk into (standing on one leaves it be)
+	for (const Contact& contact : mContacts)
+	{
+		if (contact.mSide == CollSide::Top || contact.mSide == CollSide::Bottom ||
+			contact.mOffset.LengthSq() <= 0.0f)
+		{
+			continue;
+		}
+		RigidBodyComponent* body = contact.mOther->GetOwner()->GetComponent<RigidBodyComponent>();
+		if (body)
+		{
+			// The offset pushed us out of it, so it points away from the body
+			Vector3 intoBody = Vector3::Normalize(contact.mOffset) * -1.0f;
+			float speed = Vector3::Dot(mVelocity, intoBody);
+			if (speed > 0.0f)
+			{
+				body->Push(intoBody * speed);
+			}
+		}
+	}
 }
 
 void PlayerMove::CreatePortal(bool isBlue) const
@@ -462,7 +498,7 @@ void PlayerMove::CreatePortal(bool isBlue) const
 
 	// Segment cast
 	CastInfo cast;
-	if (SegmentCast(gGame.GetColliders(), segment, cast))
+	if (gGame.GetCollisionWorld()->SegmentCast(segment, cast))
 	{
 		// Allow portal to attach to blocks
 		Block* hitBlock = dynamic_cast<Block*>(cast.mActor);
@@ -532,77 +568,24 @@ void PlayerMove::CreatePortal(bool isBlue) const
 
 bool PlayerMove::UpdatePortalTeleport(float deltaTime)
 {
-	// Handle cooldown so we don't instantly re-teleport
-	if (mPortalTeleportCooldown > 0.0f)
-	{
-		mPortalTeleportCooldown -= deltaTime;
-		if (mPortalTeleportCooldown > 0.0f)
-		{
-			return false;
-		}
-	}
-
-	Portal* bluePortal = gGame.GetBluePortal();
-	Portal* orangePortal = gGame.GetOrangePortal();
-
-	// Need both portals to teleport
-	if (!bluePortal || !orangePortal)
-	{
-		return false;
-	}
-
 	const CollisionComponent* self = mOwner->GetComponent<CollisionComponent>();
-	if (!self)
-	{
-		return false;
-	}
-
-	Portal* entryPortal = nullptr;
-	Portal* exitPortal = nullptr;
-
-	// Check intersection with blue portal
-	if (CollisionComponent* blueColl = bluePortal->GetComponent<CollisionComponent>();
-		blueColl && self->Intersect(blueColl))
-	{
-		entryPortal = bluePortal;
-		exitPortal = orangePortal;
-	}
-	// Check intersection with orange portal
-	else if (CollisionComponent* orangeColl = orangePortal->GetComponent<CollisionComponent>();
-			 orangeColl && self->Intersect(orangeColl))
-	{
-		entryPortal = orangePortal;
-		exitPortal = bluePortal;
-	}
-
-	if (!entryPortal)
+	if (!gGame.GetPortalSystem()->TryTeleport(self, mPortalPolicy, deltaTime))
 	{
 		return false;
 	}
 
-	// Perform the teleport
-	DoPortalTeleport(entryPortal, exitPortal);
 	gGame.GetAudio()->PlaySound("PortalTeleport.ogg");
-
-	// Start cooldown
-	mPortalTeleportCooldown = PORTAL_TELEPORT_COOLDOWN;
-
 	return true;
 }
 
-void PlayerMove::DoPortalTeleport(Portal* entryPortal, Portal* exitPortal)
+void PlayerMove::DoPortalTeleport(const PortalTransfer& transfer)
 {
-	if (!entryPortal || !exitPortal)
-	{
-		return;
-	}
-
 	Transform& xform = mOwner->GetTransform();
 
 	// NEW PLAYER POSITION
 
-	Vector3 entryForward = entryPortal->GetTransform().GetForward();
-	Vector3 exitForward = exitPortal->GetTransform().GetForward();
+	const Vector3& entryForward = transfer.mEntryForward;
+	const Vector3& exitForward = transfer.mExitForward;
 
 	Vector3 baseTeleportPos;
 
@@ -610,14 +593,13 @@ void PlayerMove::DoPortalTeleport(Portal* entryPortal, Portal* exitPortal)
 	if (Math::NearlyEqual(fabsf(entryForward.z), 1.0f) ||
 		Math::NearlyEqual(fabsf(exitForward.z), 1.0f))
 	{
-		baseTeleportPos = exitPortal->GetTransform().GetPosition();
+		baseTeleportPos = transfer.mExitPosition;
 	}
 
 	// Otherwise, transform current player position through portals (w = 1)
 	else
 	{
-		Vector3 pos = xform.GetPosition();
-		baseTeleportPos = entryPortal->GetPortalOutVector(pos, exitPortal, 1.0f);
+		baseTeleportPos = transfer.TransformPoint(xform.GetPosition());
 	}
 
 	// Offset along exit portal forward so we don't clip into wall
@@ -643,7 +625,7 @@ void PlayerMove::DoPortalTeleport(Portal* entryPortal, Portal* exitPortal)
 	{
 		Vector3 originalVelDir = mVelocity;
 		originalVelDir.Normalize();
-		newVelDirection = entryPortal->GetPortalOutVector(originalVelDir, exitPortal, 0.0f);
+		newVelDirection = transfer.TransformVector(originalVelDir);
 	}
 
 	// Combine new direction and length
@@ -666,8 +648,7 @@ void PlayerMove::DoPortalTeleport(Portal* entryPortal, Portal* exitPortal)
 		// Otherwise, transform original player forward through portals
 		else
 		{
-			Vector3 oldForward = xform.GetForward();
-			desiredFacing = entryPortal->GetPortalOutVector(oldForward, exitPortal, 0.0f);
+			desiredFacing = transfer.TransformVector(xform.GetForward());
 		}
 
 		// Work in the X/Y plane for yaw
@@ -4,7 +4,10 @@
 #pragma once
 #include "MoveComponent.h"
 #include "CollisionComponent.h"
+#include "CollisionWorld.h"
 #include "AudioSystem.h"
+#include "PortalSystem.h"
+#include <vector>
 
 class Crosshair;
 class Portal;
@@ -55,6 +58,10 @@ private:
 	static constexpr float PORTAL_VELOCITY_MULTIPLIER = 1.5f;
 	static constexpr float PORTAL_MIN_VELOCITY = 350.0f;
 
+	// Extra room around the player when gathering nearby colliders, so anything
+	// the player gets pushed into while resolving is still in the list
+	static constexpr float COLLISION_QUERY_MARGIN = 64.0f;
+
 	// Player death threshold
 	static constexpr float PLAYER_DEATH_Z = -750.0f;
 
@@ -85,7 +92,13 @@ private:
 	void PhysicsUpdate(float deltaTime);
 	void AddForce(const Vector3& force);
 	void FixXYVelocity();
-	CollSide FixCollision(const CollisionComponent* self, const CollisionComponent* collider) const;
+	// Pushes the player out of every collider it overlaps, filling mContacts.
+	// With useContactCache, colliders touched last time are rechecked without a
+	// new query while the player stays close to where they were.
+	void ResolveCollisions(const CollisionComponent* self, bool useContactCache);
+	std::vector<Contact> mContacts;
+	// Floor and anything else touched while standing
+	ContactCache mGroundContacts;
 
 	Crosshair* mCrosshair = nullptr;
 
@@ -97,8 +110,8 @@ private:
 
 	// Portal teleport helpers
 	bool UpdatePortalTeleport(float deltaTime);
-	void DoPortalTeleport(class Portal* entryPortal, class Portal* exitPortal);
-	float mPortalTeleportCooldown = 0.0f;
+	void DoPortalTeleport(const PortalTransfer& transfer);
+	PortalPolicy mPortalPolicy;
 
 	// Sound effects
 	SoundHandle mFootstepSound;
@@ -49,6 +49,7 @@ void Portal::Setup(const Vector3& pos, const Vector3& normal, bool isBlue)
 	}
 
 	coll->SetSize(size);
+	coll->SetLayer(CollisionLayer::Portal);
 
 	// PORTAL ROTATION LOGIC
 	constexpr Vector3 ORIGINAL_FACING = Vector3::UnitX; // Default forward
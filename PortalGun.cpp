@@ -17,6 +17,15 @@ PortalGun::PortalGun()
 
 	mColl = CreateComponent<CollisionComponent>();
 	mColl->SetSize({8.0f, 8.0f, 8.0f});
+	// Picked up by walking into it
+	mColl->SetLayer(CollisionLayer::Trigger);
+	mColl->SetOnTriggerEnter([this](CollisionComponent* other) {
+		if (other->GetLayer() == CollisionLayer::Player)
+		{
+			static_cast<Player*>(other->GetOwner())->GiveGun();
+			gGame.AddPendingDestroy(this);
+		}
+	});
 }
 void PortalGun::HandleUpdate(float deltaTime)
 {
@@ -26,19 +35,4 @@ void PortalGun::HandleUpdate(float deltaTime)
 	float rotation = GetTransform().GetRotation();
 	rotation += Math::Pi * deltaTime;
 	GetTransform().SetRotation(rotation);
-
-	// Give player gun
-	Player* player = gGame.GetPlayer();
-	if (player && mColl)
-	{
-		if (CollisionComponent* pColl = player->GetComponent<CollisionComponent>())
-		{
-			if (mColl->Intersect(pColl))
-			{
-				player->GiveGun();
-				gGame.AddPendingDestroy(this);
-				return;
-			}
-		}
-	}
 }
@@ -1,26 +1,32 @@
 #include "PortalMeshComponent.h"
-#include "Shader.h"
 #include "Mesh.h"
-#include "Actor.h"
+#include "Portal.h"
 #include "Game.h"
 #include "Renderer.h"
+#include "Shader.h"
 #include "Texture.h"
-#include "VertexArray.h"
+#include "UniformRing.h"
 
 PortalMeshComponent::PortalMeshComponent(Actor* owner)
 : MeshComponent(owner, true)
+, mPortal(static_cast<Portal*>(owner)) // Only portals have one
 {
+	// Drawn on their own, before the other alpha meshes
+	gGame.GetRenderer()->RemoveMeshComp(this, true);
+	gGame.GetRenderer()->AddPortalMeshComp(this);
+	mDrawPath = DrawPath::Portal;
+
 	SetMesh(gGame.GetRenderer()->GetMesh("Assets/Meshes/Portal.gpmesh"));
 	mMaskTexture = gGame.GetRenderer()->GetTexture("Assets/Textures/Portal/Mask.png");
 	mBlackTexture = gGame.GetRenderer()->GetTexture("Assets/Textures/Cube/Black.png");
 }
 
-void PortalMeshComponent::Draw(Shader* shader)
+void PortalMeshComponent::Draw(Shader* shader, const UniformRing& drawData)
 {
 	if (mMesh)
 	{
 		// Set the world transform
-		shader->SetMatrixUniform("uWorldTransform", mOwner->GetTransform().GetWorldTransform());
+		shader->SetDrawIndex(drawData.Bind(mDrawData));
 
 		// Set the active texture
 		Texture* t = mMesh->GetTexture(mTextureIndex);
@@ -32,10 +38,7 @@ void PortalMeshComponent::Draw(Shader* shader)
 		// Set the mask and render target textures
 		mMaskTexture->SetActive(1);
 
-		VertexArray* va = mMesh->GetVertexArray();
-		va->SetActive();
-
-		glDrawElements(GL_TRIANGLES, static_cast<int>(va->GetNumIndices()), GL_UNSIGNED_INT,
-					   nullptr);
+		mMesh->SetActive();
+		mMesh->Draw();
 	}
 }
@@ -8,10 +8,12 @@ protected:
 	friend class Actor;
 
 public:
+	class Portal* GetPortal() const { return mPortal; }
 	// Draw this mesh component
-	void Draw(class Shader* shader) override;
+	void Draw(class Shader* shader, const class UniformRing& drawData) override;
 
 private:
+	class Portal* mPortal;
 	class Texture* mMaskTexture = nullptr;
 	class Texture* mBlackTexture = nullptr;
 };
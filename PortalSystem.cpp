@@ -0,0 +1,239 @@
+#include "PortalSystem.h"
+#include <algorithm>
+#include "Game.h"
+#include "Portal.h"
+#include "CollisionComponent.h"
+#include "CollisionWorld.h"
+#include "PhysicsWorld.h"
+
+void PortalSystem::Update()
+{
+	// Movers have moved since last frame, so always look for them again (the
+	// transfers only change with the portals)
+	if (!RefreshIfNeeded())
+	{
+		FindNearMovers();
+	}
+}
+
+bool PortalSystem::TryTeleport(const CollisionComponent* coll, PortalPolicy& policy,
+							   float deltaTime)
+{
+	// Handle cooldown so we don't instantly re-teleport
+	if (policy.mCooldownLeft > 0.0f)
+	{
+		policy.mCooldownLeft -= deltaTime;
+		if (policy.mCooldownLeft > 0.0f)
+		{
+			return false;
+		}
+	}
+
+	RefreshIfNeeded();
+	if (!mHasTransfers || !coll || std::ranges::find(mNearMovers, coll) == mNearMovers.end())
+	{
+		return false;
+	}
+
+	// Blue is checked first
+	const PortalTransfer* transfer = nullptr;
+	if (coll->Intersect(mPortalColls[0]))
+	{
+		transfer = &mTransfers[0];
+	}
+	else if (coll->Intersect(mPortalColls[1]))
+	{
+		transfer = &mTransfers[1];
+	}
+
+	if (!transfer)
+	{
+		return false;
+	}
+
+	policy.mCooldownLeft = policy.mCooldown;
+	if (policy.mOnTeleport)
+	{
+		policy.mOnTeleport(*transfer);
+	}
+	return true;
+}
+
+const PortalTransfer* PortalSystem::GetTransfer(const Actor* entry) const
+{
+	if (!mHasTransfers || !entry)
+	{
+		return nullptr;
+	}
+
+	for (const PortalTransfer& transfer : mTransfers)
+	{
+		if (transfer.mEntry == entry)
+		{
+			return &transfer;
+		}
+	}
+	return nullptr;
+}
+
+void PortalSystem::SegmentCastPacket(std::span<PortalCastQuery> queries, bool collidersOnly)
+{
+	RefreshIfNeeded();
+
+	mCasts.clear();
+	mCastStates.clear();
+	for (size_t i = 0; i < queries.size(); i++)
+	{
+		PortalCastQuery& query = queries[i];
+		query.mHit = false;
+		query.mInfo = CastInfo();
+
+		SegmentCastQuery cast;
+		cast.mSegment = LineSegment(query.mStart, query.mStart + query.mDir * query.mLength);
+		cast.mIgnoreActor = query.mIgnoreActor;
+		mCasts.emplace_back(cast);
+		mCastStates.emplace_back(PortalCastState{i, query.mDir, query.mLength, 0});
+	}
+
+	CollisionWorld* world = gGame.GetCollisionWorld();
+	while (!mCasts.empty())
+	{
+		world->SegmentCastPacket(mCasts, collidersOnly);
+
+		// Keep the casts that went into a portal (in place) for the next packet
+		size_t numNext = 0;
+		for (size_t i = 0; i < mCasts.size(); i++)
+		{
+			const SegmentCastQuery& cast = mCasts[i];
+			PortalCastState state = mCastStates[i];
+			PortalCastQuery& query = queries[state.mQuery];
+
+			LineSegment segment = cast.mSegment;
+			query.mHit = cast.mHit;
+			query.mInfo = cast.mInfo;
+			if (cast.mHit)
+			{
+				segment.mEnd = cast.mInfo.mPoint;
+			}
+			if (query.mOutSegments)
+			{
+				query.mOutSegments->emplace_back(segment);
+			}
+
+			const PortalTransfer* transfer = cast.mHit ? GetTransfer(cast.mInfo.mActor) : nullptr;
+			if (!transfer || state.mPortals >= query.mMaxPortals)
+			{
+				continue;
+			}
+
+			// Come out of the exit portal with the length that's left, ignoring
+			// the exit portal itself
+			Vector3 dir = transfer->TransformVector(state.mDir);
+			dir.Normalize();
+			Vector3 start = transfer->TransformPoint(cast.mInfo.mPoint) + dir * PORTAL_EXIT_OFFSET;
+			float lengthLeft = Math::Max(state.mLengthLeft - segment.Length(), 0.0f);
+
+			SegmentCastQuery next;
+			next.mSegment = LineSegment(start, start + dir * lengthLeft);
+			next.mIgnoreActor = transfer->mExit;
+			mCasts[numNext] = next;
+			mCastStates[numNext] = PortalCastState{state.mQuery, dir, lengthLeft, state.mPortals + 1};
+			numNext++;
+		}
+		mCasts.resize(numNext);
+		mCastStates.resize(numNext);
+	}
+}
+
+bool PortalSystem::RefreshIfNeeded()
+{
+	Portal* portals[2] = {gGame.GetBluePortal(), gGame.GetOrangePortal()};
+	for (int i = 0; i < 2 && !mArePortalsDirty; i++)
+	{
+		if (mHasTransfers && portals[i]->GetTransform().GetVersion() != mPortalVersions[i])
+		{
+			mArePortalsDirty = true;
+		}
+	}
+
+	if (!mArePortalsDirty)
+	{
+		return false;
+	}
+	Refresh();
+	FindNearMovers();
+	return true;
+}
+
+void PortalSystem::Refresh()
+{
+	mArePortalsDirty = false;
+
+	Portal* portals[2] = {gGame.GetBluePortal(), gGame.GetOrangePortal()};
+	mHasTransfers = false;
+	if (!portals[0] || !portals[1])
+	{
+		return;
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		mPortalColls[i] = portals[i]->GetComponent<CollisionComponent>();
+		if (!mPortalColls[i])
+		{
+			return;
+		}
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		Portal* entry = portals[i];
+		Portal* exit = portals[1 - i];
+		Transform& entryXform = entry->GetTransform();
+		Transform& exitXform = exit->GetTransform();
+
+		Matrix4 entryInverse = entryXform.GetWorldTransform();
+		entryInverse.Invert();
+
+		PortalTransfer& transfer = mTransfers[i];
+		transfer.mEntry = entry;
+		transfer.mExit = exit;
+		transfer.mMatrix = entryInverse * Matrix4::CreateRotationZ(Math::Pi) *
+						   exitXform.GetWorldTransform();
+		transfer.mEntryForward = entryXform.GetForward();
+		transfer.mExitForward = exitXform.GetForward();
+		transfer.mExitPosition = exitXform.GetPosition();
+		mPortalVersions[i] = entryXform.GetVersion();
+	}
+	mHasTransfers = true;
+
+	// Bodies resting where a portal opened can drop into it now
+	for (const CollisionComponent* portalColl : mPortalColls)
+	{
+		gGame.GetPhysicsWorld()->WakeTouching(portalColl->GetAABB());
+	}
+}
+
+void PortalSystem::FindNearMovers()
+{
+	mNearMovers.clear();
+	if (!mHasTransfers)
+	{
+		return;
+	}
+
+	// Movers are whatever the portal layer overlaps (player, pellets, turrets, cubes)
+	for (const CollisionComponent* portalColl : mPortalColls)
+	{
+		AABB box = portalColl->GetAABB();
+		box.Expand(NEAR_MARGIN);
+		gGame.GetCollisionWorld()->QueryOverlapping(box, portalColl, mOverlapHits);
+		for (CollisionComponent* mover : mOverlapHits)
+		{
+			if (std::ranges::find(mNearMovers, mover) == mNearMovers.end())
+			{
+				mNearMovers.emplace_back(mover);
+			}
+		}
+	}
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include "Math.h"
+#include "AABB.h"
+#include "SegmentCast.h"
+#include "CollisionWorld.h"
+#include <functional>
+#include <span>
+#include <vector>
+
+class Actor;
+class Portal;
+class CollisionComponent;
+
+// Everything needed to move something from one portal out the other
+struct PortalTransfer
+{
+	Portal* mEntry = nullptr;
+	Portal* mExit = nullptr;
+	// Entry portal's inverse world transform, turned around, then the exit's world
+	// transform (the same math as Portal::GetPortalOutVector, multiplied out once)
+	Matrix4 mMatrix;
+	Vector3 mEntryForward;
+	Vector3 mExitForward;
+	Vector3 mExitPosition;
+
+	Vector3 TransformPoint(const Vector3& point) const
+	{
+		return Vector3::Transform(point, mMatrix, 1.0f);
+	}
+	Vector3 TransformVector(const Vector3& vec) const
+	{
+		return Vector3::Transform(vec, mMatrix, 0.0f);
+	}
+};
+
+// How one actor goes through portals. Each mover keeps its own.
+struct PortalPolicy
+{
+	// Seconds after a teleport before the actor can teleport again
+	float mCooldown = 0.0f;
+	// Moves the actor through the portals (position, velocity boost, facing...)
+	std::function<void(const PortalTransfer&)> mOnTeleport;
+
+	// Time left on the cooldown, counted down by PortalSystem::TryTeleport
+	float mCooldownLeft = 0.0f;
+};
+
+// A segment cast that carries on out of the linked portal when it hits one
+// (see PortalSystem::SegmentCastPacket)
+struct PortalCastQuery
+{
+	Vector3 mStart;
+	// Normalized direction
+	Vector3 mDir;
+	// Total length of the cast, shared by every piece of it
+	float mLength = 0.0f;
+	const Actor* mIgnoreActor = nullptr;
+	// How many portals the cast can go through
+	int mMaxPortals = 1;
+	// If set, each piece of the cast is appended here (the last one ends at mInfo)
+	std::vector<LineSegment>* mOutSegments = nullptr;
+
+	// Filled in by the cast. This is the hit that ended it, which is a portal if
+	// it ran out of portals to go through.
+	CastInfo mInfo;
+	bool mHit = false;
+};
+
+// Teleports movers (player, pellets, turrets, cubes) through the blue/orange portals.
+// Once per frame, Update uses the broadphase to find the movers near a portal
+// (the cached transfer matrices are only rebuilt when a portal changes). Movers
+// still call TryTeleport right after they move (before anything else reacts to
+// the new position), but only the ones found near a portal pay for an overlap test.
+class PortalSystem
+{
+public:
+	// Called once per frame before actors update
+	void Update();
+
+	// Called when either portal is created or removed
+	void InvalidatePortals() { mArePortalsDirty = true; }
+
+	// Ticks the policy's cooldown, then teleports coll's actor through policy if
+	// it's off cooldown and overlapping a portal. Call once per frame per mover.
+	bool TryTeleport(const CollisionComponent* coll, PortalPolicy& policy, float deltaTime);
+
+	// Transfer into entry and out the other portal, or nullptr if entry isn't one
+	// of the two linked portals
+	const PortalTransfer* GetTransfer(const Actor* entry) const;
+
+	// Casts a batch of segments like CollisionWorld::SegmentCastPacket, except a
+	// cast that hits a linked portal continues from the matching point on the
+	// other one with whatever length it has left. Every cast at the same depth
+	// goes out as one packet.
+	void SegmentCastPacket(std::span<PortalCastQuery> queries, bool collidersOnly = true);
+
+private:
+	// Anything further than this from a portal at the start of a frame can't
+	// reach it by the time it checks (far more than a mover covers in a frame)
+	static constexpr float NEAR_MARGIN = 100.0f;
+
+	// A cast goes this far past the exit portal before it can hit anything, so
+	// it doesn't immediately hit the wall the exit portal is on
+	static constexpr float PORTAL_EXIT_OFFSET = 5.5f;
+
+	// Recomputes the transfers and movers near the portals if the portals changed
+	// (returns whether it did)
+	bool RefreshIfNeeded();
+	void Refresh();
+	// Broadphase query for the movers within NEAR_MARGIN of a portal
+	void FindNearMovers();
+
+	// Blue -> orange and orange -> blue, valid only with both portals
+	PortalTransfer mTransfers[2];
+	bool mHasTransfers = false;
+	const CollisionComponent* mPortalColls[2] = {nullptr, nullptr};
+	unsigned int mPortalVersions[2] = {0, 0};
+	bool mArePortalsDirty = true;
+
+	// Movers whose box was within NEAR_MARGIN of a portal
+	std::vector<CollisionComponent*> mNearMovers;
+
+	// Scratch for SegmentCastPacket: the casts at the current depth, and for each
+	// one the query it belongs to, its length left and portals gone through
+	struct PortalCastState
+	{
+		size_t mQuery = 0;
+		Vector3 mDir;
+		float mLengthLeft = 0.0f;
+		int mPortals = 0;
+	};
+	std::vector<SegmentCastQuery> mCasts;
+	std::vector<PortalCastState> mCastStates;
+	// Scratch for the broadphase queries
+	std::vector<CollisionComponent*> mOverlapHits;
+};
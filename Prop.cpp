@@ -48,5 +48,5 @@ void Prop::EnableCollision()
 
 	// Registered w/ game's collider list
 	// since this has collision on
-	gGame.AddCollider(this);
+	gGame.AddCollider(this, true);
 }
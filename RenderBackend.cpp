@@ -0,0 +1,17 @@
+#include "RenderBackend.h"
+#include "GLRenderBackend.h"
+#include "NullRenderBackend.h"
+
+RenderBackend* gRenderBackend = nullptr;
+
+RenderBackend* RenderBackend::Create(RenderBackendType type)
+{
+	switch (type)
+	{
+	case RenderBackendType::Null:
+		return new NullRenderBackend();
+	case RenderBackendType::GL:
+	default:
+		return new GLRenderBackend();
+	}
+}
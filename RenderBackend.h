@@ -0,0 +1,167 @@
+#pragma once
+#include <GL/glew.h>
+#include <SDL3/SDL.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class RenderBackendType
+{
+	GL,
+	Null
+};
+
+// What the renderer asked the GPU to do
+struct RenderCounts
+{
+	unsigned int mDrawCalls = 0;
+	// Across every instance
+	unsigned int mTriangles = 0;
+	// Anything GLState lets through, plus viewports and framebuffer binds
+	unsigned int mStateChanges = 0;
+	// Uniforms set
+	unsigned int mUniformUploads = 0;
+	// Uniform buffer ranges bound
+	unsigned int mBlockBinds = 0;
+
+	void Add(const RenderCounts& other)
+	{
+		mDrawCalls += other.mDrawCalls;
+		mTriangles += other.mTriangles;
+		mStateChanges += other.mStateChanges;
+		mUniformUploads += other.mUniformUploads;
+		mBlockBinds += other.mBlockBinds;
+	}
+};
+
+// Everything the renderer (and the resources it owns) asks of the GPU. Renderer
+// is the frontend: culling, sorting and the portal passes all happen there, and
+// only reach the GPU through the backend. The calls are GL's (same enums and
+// object names), so the GL backend is a thin layer over it, and the Null backend
+// runs the whole frontend without a GL context. Both count what they're asked to
+// do (see RenderCounts). State changes come through GLState first, so only real
+// changes get here.
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() = default;
+
+	static RenderBackend* Create(RenderBackendType type);
+
+	// Between the last two Presents (the last frame the renderer drew)
+	const RenderCounts& GetLastFrameCounts() const { return mLastFrameCounts; }
+
+	// Creates the window (and context)
+	virtual bool Initialize(int width, int height) = 0;
+	virtual void Shutdown() = 0;
+	virtual SDL_Window* GetWindow() const = 0;
+	// Shows the frame that was drawn
+	virtual void Present() = 0;
+
+	// Frame
+	virtual void SetViewport(int width, int height) = 0;
+	virtual void SetClearColor(float r, float g, float b, float a) = 0;
+	virtual void Clear(GLbitfield mask) = 0;
+
+	// State
+	virtual void SetEnabled(GLenum cap, bool enabled) = 0;
+	virtual void SetDepthMask(bool write) = 0;
+	virtual void SetStencilMask(unsigned int mask) = 0;
+	virtual void SetStencilFunc(GLenum func, int ref, unsigned int mask) = 0;
+	virtual void SetStencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass) = 0;
+	virtual void SetBlendEquation(GLenum color, GLenum alpha) = 0;
+	virtual void SetBlendFunc(GLenum srcColor, GLenum dstColor, GLenum srcAlpha,
+							  GLenum dstAlpha) = 0;
+	virtual void UseProgram(GLuint program) = 0;
+	virtual void BindVertexArray(GLuint vertexArray) = 0;
+	virtual void SetActiveTexture(unsigned int unit) = 0;
+	virtual void BindTexture(GLenum target, GLuint texture) = 0;
+
+	// Triangles from the bound vertex array's index buffer (unsigned int indices)
+	virtual void DrawIndexed(unsigned int firstIndex, unsigned int numIndices) = 0;
+	virtual void DrawIndexedInstanced(unsigned int firstIndex, unsigned int numIndices,
+									  int numInstances) = 0;
+
+	// Uniforms of the program in use. Matrices are row major.
+	virtual void SetUniformMatrix4(GLint location, const float* matrix) = 0;
+	// 1 to 4 floats (float, vec2, vec3 or vec4)
+	virtual void SetUniformFloats(GLint location, int numFloats, const float* values) = 0;
+	virtual void SetUniformInt(GLint location, int value) = 0;
+
+	// Buffers
+	virtual GLuint CreateBuffer() = 0;
+	virtual void DeleteBuffer(GLuint buffer) = 0;
+	virtual void BindBuffer(GLenum target, GLuint buffer) = 0;
+	// To whatever's bound to target
+	virtual void BufferData(GLenum target, size_t size, const void* data, GLenum usage) = 0;
+	virtual void BufferSubData(GLenum target, size_t offset, size_t size, const void* data) = 0;
+	virtual void CopyBuffer(GLuint from, GLuint to, size_t size) = 0;
+	virtual void BindBufferRange(GLenum target, unsigned int index, GLuint buffer, size_t offset,
+								 size_t size) = 0;
+	virtual size_t GetUniformBufferAlignment() const = 0;
+
+	// Vertex arrays (attributes are floats from the buffer bound to GL_ARRAY_BUFFER)
+	virtual GLuint CreateVertexArray() = 0;
+	virtual void DeleteVertexArray(GLuint vertexArray) = 0;
+	virtual void EnableVertexAttribute(unsigned int index, int numFloats, int stride,
+									   size_t offset, unsigned int divisor = 0) = 0;
+	virtual void DisableVertexAttribute(unsigned int index) = 0;
+
+	// Textures (to whatever's bound to target). rowLength is in pixels, 0 if
+	// the rows are packed.
+	virtual GLuint CreateTexture() = 0;
+	virtual void DeleteTexture(GLuint texture) = 0;
+	virtual void TexImage2D(GLenum target, GLint internalFormat, int width, int height,
+							GLenum format, const void* pixels, int rowLength = 0) = 0;
+	virtual void TexImage3D(GLenum target, GLint internalFormat, int width, int height,
+							int depth, GLenum format) = 0;
+	virtual void TexSubImage3D(GLenum target, int layer, int width, int height, GLenum format,
+							   const void* pixels) = 0;
+	virtual void SetTextureFilter(GLenum target, GLint minFilter, GLint magFilter) = 0;
+	virtual void GenerateMipmap(GLenum target) = 0;
+
+	// Shader programs. CreateProgram returns 0 if it didn't compile or link.
+	virtual GLuint CreateProgram(const std::string& vertSource, const std::string& fragSource,
+								 const std::string& name) = 0;
+	virtual void DeleteProgram(GLuint program) = 0;
+	// Uniforms that have a location (not in blocks), arrays by their plain name
+	virtual void GetActiveUniforms(GLuint program,
+								   std::vector<std::pair<std::string, GLint>>& outUniforms) = 0;
+	// Does nothing if program doesn't have the block
+	virtual void SetUniformBlockBinding(GLuint program, const char* block,
+										unsigned int binding) = 0;
+
+	// Occlusion queries (GL_ANY_SAMPLES_PASSED). Conditional rendering might
+	// not be supported, in which case everything is drawn.
+	virtual GLuint CreateQuery() = 0;
+	virtual void DeleteQuery(GLuint query) = 0;
+	virtual void BeginQuery(GLuint query) = 0;
+	virtual void EndQuery() = 0;
+	// False if the GPU isn't done with the query yet (never waits for it)
+	virtual bool GetQueryResult(GLuint query, bool& outAnySamples) = 0;
+	virtual void BeginConditionalRender(GLuint query) = 0;
+	virtual void EndConditionalRender() = 0;
+
+	// Framebuffers that draw to a 2D texture. 0 is the window.
+	virtual GLuint CreateFramebuffer(GLuint colorTexture) = 0;
+	virtual void DeleteFramebuffer(GLuint framebuffer) = 0;
+	virtual void BindFramebuffer(GLuint framebuffer) = 0;
+	// Scales the window's image onto framebuffer
+	virtual void BlitFromWindow(GLuint framebuffer, int srcWidth, int srcHeight, int dstWidth,
+								int dstHeight) = 0;
+
+protected:
+	// Present calls this once the frame is done
+	void EndFrameCounts()
+	{
+		mLastFrameCounts = mCounts;
+		mCounts = RenderCounts();
+	}
+
+	// Everything since the last Present
+	RenderCounts mCounts;
+	RenderCounts mLastFrameCounts;
+};
+
+// The renderer's, set while it's initialized
+extern RenderBackend* gRenderBackend;
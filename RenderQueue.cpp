@@ -0,0 +1,133 @@
+#include "RenderQueue.h"
+#include "Frustum.h"
+#include "Mesh.h"
+#include "MeshComponent.h"
+#include "Renderer.h"
+#include "Texture.h"
+
+void RenderQueue::Clear()
+{
+	mItems.clear();
+	mAlphaItems.clear();
+}
+
+void RenderQueue::Gather(const std::vector<MeshComponent*>& comps, unsigned int shaderId,
+						 const Frustum& frustum, const Matrix4& viewProj, CullStats& stats)
+{
+	for (MeshComponent* mc : comps)
+	{
+		stats.mTested++;
+		if (!mc->IsVisible(frustum))
+		{
+			stats.mCulled++;
+			continue;
+		}
+		mItems.emplace_back(MakeKey(shaderId, mc, viewProj), mc);
+	}
+}
+
+void RenderQueue::Sort()
+{
+	// LSD radix sort a byte at a time, which keeps equal keys in gather order.
+	// Bytes every key shares (unused bits, one shader) are skipped.
+	mScratch.resize(mItems.size());
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		size_t counts[256] = {};
+		for (const DrawItem& item : mItems)
+		{
+			counts[(item.mKey >> shift) & 0xFF]++;
+		}
+		if (mItems.empty() || counts[(mItems[0].mKey >> shift) & 0xFF] == mItems.size())
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (size_t& count : counts)
+		{
+			size_t bucketSize = count;
+			count = offset;
+			offset += bucketSize;
+		}
+		for (const DrawItem& item : mItems)
+		{
+			mScratch[counts[(item.mKey >> shift) & 0xFF]++] = item;
+		}
+		mItems.swap(mScratch);
+	}
+}
+
+void RenderQueue::GatherAlpha(std::vector<DrawItem>& order,
+							  const std::vector<MeshComponent*>& comps, const Frustum& frustum,
+							  const Matrix4& viewProj, CullStats& stats)
+{
+	if (order.size() != comps.size())
+	{
+		order.clear();
+		for (MeshComponent* mc : comps)
+		{
+			order.emplace_back(0, mc);
+		}
+	}
+
+	// Everything is keyed (even what's culled) so the order stays complete
+	for (DrawItem& item : order)
+	{
+		item.mKey = MakeAlphaKey(item.mComp, viewProj);
+	}
+	for (size_t i = 1; i < order.size(); i++)
+	{
+		DrawItem item = order[i];
+		size_t j = i;
+		while (j > 0 && order[j - 1].mKey > item.mKey)
+		{
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = item;
+	}
+
+	for (const DrawItem& item : order)
+	{
+		stats.mTested++;
+		if (!item.mComp->IsVisible(frustum))
+		{
+			stats.mCulled++;
+			continue;
+		}
+		mAlphaItems.emplace_back(item);
+	}
+}
+
+std::span<const DrawItem> RenderQueue::GetItems(Layer layer) const
+{
+	return layer == Layer::Opaque ? mItems : mAlphaItems;
+}
+
+uint64_t RenderQueue::MakeKey(unsigned int shaderId, const MeshComponent* mc,
+							  const Matrix4& viewProj)
+{
+	// Ids only need to be the same for the same state, so GL names are cut to size
+	const Mesh* mesh = mc->GetMesh();
+	const Texture* texture = mc->GetTexture();
+	uint64_t textureId = texture ? texture->GetTextureID() & 0xFFFF : 0;
+	uint64_t meshId = mesh ? mesh->GetID() & 0xFFFF : 0;
+	return static_cast<uint64_t>(shaderId & 0x3F) << 56 | textureId << 40 |
+		   meshId << DEPTH_BITS | GetDepth(mc, viewProj);
+}
+
+uint64_t RenderQueue::MakeAlphaKey(const MeshComponent* mc, const Matrix4& viewProj)
+{
+	// Far to near
+	return MAX_DEPTH - GetDepth(mc, viewProj);
+}
+
+uint64_t RenderQueue::GetDepth(const MeshComponent* mc, const Matrix4& viewProj)
+{
+	// Depth of the middle of the bounds (so lasers sort by their segments, not
+	// where the turret is)
+	Vector3 proj = Vector3::TransformWithPerspDiv(mc->GetWorldCenter(), viewProj);
+	return static_cast<uint64_t>(Math::Clamp(proj.z, 0.0f, 1.0f) *
+								 static_cast<float>(MAX_DEPTH));
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "Math.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct Frustum;
+struct CullStats;
+class MeshComponent;
+
+// A mesh component to draw in a pass, and where it sorts
+struct DrawItem
+{
+	uint64_t mKey = 0;
+	MeshComponent* mComp = nullptr;
+};
+
+// Everything one scene pass draws, culled as it's gathered.
+// Opaque items are radix sorted by a 64-bit key:
+//   shader (6) | texture (16) | mesh (16) | depth (24)
+// so draws are grouped by state, front to back within a group (less overdraw).
+// Alpha items are keyed by depth alone and blend back to front. They're
+// insertion sorted starting from the pass's order last frame, which barely
+// changes, so that's close to O(n).
+class RenderQueue
+{
+public:
+	enum class Layer
+	{
+		Opaque,
+		Alpha
+	};
+
+	void Clear();
+
+	// Adds every opaque component in comps that's inside frustum, counting into
+	// stats. shaderId is just for grouping (whatever the caller draws them with).
+	void Gather(const std::vector<MeshComponent*>& comps, unsigned int shaderId,
+				const Frustum& frustum, const Matrix4& viewProj, CullStats& stats);
+	// Sorts the opaque items
+	void Sort();
+
+	// Keys and sorts every alpha component in comps, then adds the ones inside
+	// frustum. order is the caller's to keep between frames for this pass: it
+	// starts from it and leaves the new order in it (clear it whenever comps
+	// changes, to start over from comps).
+	void GatherAlpha(std::vector<DrawItem>& order, const std::vector<MeshComponent*>& comps,
+					 const Frustum& frustum, const Matrix4& viewProj, CullStats& stats);
+
+	std::span<const DrawItem> GetItems(Layer layer) const;
+
+private:
+	static uint64_t MakeKey(unsigned int shaderId, const MeshComponent* mc,
+							const Matrix4& viewProj);
+	static uint64_t MakeAlphaKey(const MeshComponent* mc, const Matrix4& viewProj);
+	// Where mc's bounds are between the near (0) and far (MAX_DEPTH) planes
+	static uint64_t GetDepth(const MeshComponent* mc, const Matrix4& viewProj);
+
+	static constexpr int DEPTH_BITS = 24;
+	static constexpr uint64_t MAX_DEPTH = (1ull << DEPTH_BITS) - 1;
+
+	std::vector<DrawItem> mItems;
+	std::vector<DrawItem> mScratch;
+	std::vector<DrawItem> mAlphaItems;
+};
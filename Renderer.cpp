@@ -9,16 +9,30 @@
 #include "PortalMeshComponent.h"
 #include "Game.h"
 #include "Portal.h"
-#include <GL/glew.h>
+#include "Frustum.h"
+#include "InstanceBatch.h"
+#include "MeshBuffer.h"
+#include "UniformRing.h"
 
-Renderer::Renderer(Game* game)
+namespace
+{
+	const Uniform<int> REUSE("uReuse");
+	const Uniform<Vector4> REUSE_FROM("uReuseFrom");
+	const Uniform<Vector4> REUSE_TO("uReuseTo");
+} // namespace
+
+Renderer::Renderer(Game* game, RenderBackendType backendType)
 : mGame(game)
 , mSpriteShader(nullptr)
+, mMeshBuffer(nullptr)
+, mPassUniforms(nullptr)
+, mDrawUniforms(nullptr)
 , mSpriteVerts(nullptr)
 , mMeshShader(nullptr)
+, mInstancedShader(nullptr)
 , mPortalShader(nullptr)
+, mBackendType(backendType)
 , mWindow(nullptr)
-, mContext(nullptr)
 , mScreenWidth(1024.0f)
 , mScreenHeight(768.0f)
 {
@@ -29,50 +43,13 @@ bool Renderer::Initialize(float width, float height)
 	mScreenWidth = width;
 	mScreenHeight = height;
 
-	// Set OpenGL attributes
-#ifndef __EMSCRIPTEN__
-	// Use the core OpenGL profile
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
-	// Specify version 3.3
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
-#endif
-	// Request a color buffer with 8-bits per RGBA channel
-	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8);
-	SDL_GL_SetAttribute(SDL_GL_GREEN_SIZE, 8);
-	SDL_GL_SetAttribute(SDL_GL_BLUE_SIZE, 8);
-	SDL_GL_SetAttribute(SDL_GL_ALPHA_SIZE, 8);
-	SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
-	SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
-	// Enable double buffering
-	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-	// Force OpenGL to use hardware acceleration
-	SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
-
-	mWindow = SDL_CreateWindow("ITP Portal", static_cast<int>(mScreenWidth),
-							   static_cast<int>(mScreenHeight), SDL_WINDOW_OPENGL);
-	if (!mWindow)
-	{
-		SDL_Log("Failed to create window: %s", SDL_GetError());
-		return false;
-	}
-
-	// Create an OpenGL context
-	mContext = SDL_GL_CreateContext(mWindow);
-	// Turn on vsync
-	SDL_GL_SetSwapInterval(1);
-
-	// Initialize GLEW
-	glewExperimental = GL_TRUE;
-	if (glewInit() != GLEW_OK)
+	gRenderBackend = RenderBackend::Create(mBackendType);
+	if (!gRenderBackend->Initialize(static_cast<int>(mScreenWidth),
+									static_cast<int>(mScreenHeight)))
 	{
-		SDL_Log("Failed to initialize GLEW.");
 		return false;
 	}
-
-	// On some platforms, GLEW will emit a benign error code,
-	// so clear it
-	glGetError();
+	mWindow = gRenderBackend->GetWindow();
 
 	// Make sure we can create/compile shaders
 	if (!LoadShaders())
@@ -84,23 +61,88 @@ bool Renderer::Initialize(float width, float height)
 	// Create quad for drawing sprites
 	CreateSpriteVerts();
 
+	mMeshBuffer = new MeshBuffer();
+	mPassUniforms = new UniformRing(Shader::PASS_DATA_BINDING, sizeof(PassUniforms));
+	mDrawUniforms = new UniformRing(Shader::DRAW_DATA_BINDING, sizeof(Matrix4),
+									Shader::DRAW_DATA_COUNT);
+
+	for (PortalPassState& state : mPortalPasses)
+	{
+		for (unsigned int& query : state.mQueries)
+		{
+			query = gRenderBackend->CreateQuery();
+		}
+	}
+
+	// Last frame's image, for portals deeper than we draw
+	mPortalTarget = new Texture();
+	mPortalTarget->CreateForRendering(PORTAL_TARGET_SIZE, PORTAL_TARGET_SIZE, GL_RGBA8);
+	mPortalFramebuffer = gRenderBackend->CreateFramebuffer(mPortalTarget->GetTextureID());
+	gRenderBackend->BindFramebuffer(mPortalFramebuffer);
+	gRenderBackend->SetClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	gRenderBackend->Clear(GL_COLOR_BUFFER_BIT);
+	gRenderBackend->BindFramebuffer(0);
+
 	return true;
 }
 
 void Renderer::Shutdown()
 {
+	if (mNumFrames > 0)
+	{
+		const double MS_PER_FRAME = 1000.0 * static_cast<double>(mDrawTicks) /
+									static_cast<double>(SDL_GetPerformanceFrequency()) /
+									mNumFrames;
+		SDL_Log("Renderer: %u frames, %.3f ms per frame in Draw", mNumFrames, MS_PER_FRAME);
+		SDL_Log("Renderer: %u GL state calls (%u filtered as redundant)", mTotalStateStats.mCalls,
+				mTotalStateStats.mFiltered);
+		SDL_Log("Renderer: per frame %.1f draw calls, %.1f triangles, %.1f state changes, "
+				"%.1f uniform uploads, %.1f block binds",
+				static_cast<double>(mTotalCounts.mDrawCalls) / mNumFrames,
+				static_cast<double>(mTotalCounts.mTriangles) / mNumFrames,
+				static_cast<double>(mTotalCounts.mStateChanges) / mNumFrames,
+				static_cast<double>(mTotalCounts.mUniformUploads) / mNumFrames,
+				static_cast<double>(mTotalCounts.mBlockBinds) / mNumFrames);
+	}
+
 	UnloadData();
+	delete mMeshBuffer;
+	delete mPassUniforms;
+	delete mDrawUniforms;
 	delete mSpriteVerts;
 	mSpriteShader->Unload();
 	delete mSpriteShader;
 	mMeshShader->Unload();
 	delete mMeshShader;
-	SDL_GL_DestroyContext(mContext);
-	SDL_DestroyWindow(mWindow);
+	mInstancedShader->Unload();
+	delete mInstancedShader;
+	for (PortalPassState& state : mPortalPasses)
+	{
+		for (unsigned int query : state.mQueries)
+		{
+			gRenderBackend->DeleteQuery(query);
+		}
+	}
+	gRenderBackend->DeleteFramebuffer(mPortalFramebuffer);
+	mPortalTarget->Unload();
+	delete mPortalTarget;
+	gRenderBackend->Shutdown();
+	delete gRenderBackend;
+	gRenderBackend = nullptr;
+	mWindow = nullptr;
 }
 
 void Renderer::UnloadData()
 {
+	mStaticGeometry.Clear();
+
+	// Batches use the meshes' buffers
+	for (auto i : mInstanceBatches)
+	{
+		delete i.second;
+	}
+	mInstanceBatches.clear();
+
 	// Destroy textures
 	for (const auto& i : mTextures)
 	{
@@ -120,6 +162,8 @@ void Renderer::UnloadData()
 
 void Renderer::Draw()
 {
+	const Uint64 START = SDL_GetPerformanceCounter();
+
 	// Fix for issue where "mouse grab" doesn't always work
 	SDL_WindowFlags windowFlags = SDL_GetWindowFlags(mWindow);
 	if (windowFlags & SDL_WINDOW_INPUT_FOCUS)
@@ -129,47 +173,73 @@ void Renderer::Draw()
 		SDL_WarpMouseInWindow(mWindow, x, y);
 	}
 
-	// Draw the main framebuffer
-	Draw3DScene(mView, mProjection, static_cast<int>(mScreenWidth),
-				static_cast<int>(mScreenHeight));
+	gGLState.ResetStats();
 
-	// Draw the scene for the blue portal then orange portal, if they exist
-	Portal* bluePortal = mGame->GetBluePortal();
-	Portal* orangePortal = mGame->GetOrangePortal();
+	// Only does anything if a static mesh component went away since the level loaded
+	mStaticGeometry.Build();
 
-	for (unsigned i = 0; i < MAX_PORTAL_RECURSIONS; i++)
+	// Bounds only change between frames, so every pass culls with the same ones
+	mCullStats.clear();
+	for (MeshComponent* mc : mMeshComps)
+	{
+		mc->UpdateWorldBounds();
+	}
+	for (MeshComponent* mc : mMeshCompsAlpha)
+	{
+		mc->UpdateWorldBounds();
+	}
+	for (PortalMeshComponent* pmc : mPortalMeshComps)
 	{
-		if (bluePortal && orangePortal)
+		pmc->UpdateWorldBounds();
+	}
+	for (const auto& [mesh, batch] : mInstanceBatches)
+	{
+		for (MeshComponent* mc : batch->GetComps())
 		{
-			glEnable(GL_CULL_FACE);
-			glEnable(GL_CLIP_DISTANCE0);
+			mc->UpdateWorldBounds();
+		}
+	}
 
-			Draw3DScene(mBluePortal.mView, mProjection, static_cast<int>(mScreenWidth),
-						static_cast<int>(mScreenHeight), orangePortal, &mBluePortal, BLUE_MASK | i);
+	// Last frame's portal queries, before the main pass records over them
+	ReadPortalQueries();
 
-			Draw3DScene(mOrangePortal.mView, mProjection, static_cast<int>(mScreenWidth),
-						static_cast<int>(mScreenHeight), bluePortal, &mOrangePortal,
-						ORANGE_MASK | i);
+	// Draw the main framebuffer, recording whether any of each portal is visible
+	Portal* portals[NUM_PORTALS] = {mGame->GetBluePortal(), mGame->GetOrangePortal()};
+	const bool BOTH_PORTALS = portals[0] && portals[1];
+	for (int k = 0; k < NUM_PORTALS; k++)
+	{
+		mPortalPasses[k].mRecordQuery = BOTH_PORTALS ? mPortalPasses[k].mQueries[0] : 0;
+		mPortalPasses[k].mQueryIssued = false;
+	}
+	Draw3DScene(mView, mProjection, static_cast<int>(mScreenWidth),
+				static_cast<int>(mScreenHeight), mAlphaOrders[0]);
 
-			// Recalculate the views for the next recursion
-			PortalViewRecurse(mBluePortal, bluePortal, orangePortal);
-			PortalViewRecurse(mOrangePortal, orangePortal, bluePortal);
+	if (BOTH_PORTALS)
+	{
+		DrawPortalPasses(portals);
 
-			glDisable(GL_CULL_FACE);
-			glDisable(GL_CLIP_DISTANCE0);
-		}
+		// Keep this frame for the next one's deepest portals (before the UI goes on)
+		gRenderBackend->BlitFromWindow(mPortalFramebuffer, static_cast<int>(mScreenWidth),
+									   static_cast<int>(mScreenHeight), mPortalTarget->GetWidth(),
+									   mPortalTarget->GetHeight());
 	}
 
-	glDisable(GL_CULL_FACE);
+	gGLState.SetEnabled(GL_CULL_FACE, false);
+	gGLState.SetEnabled(GL_CLIP_DISTANCE0, false);
 
 	// Now disable depth buffering
-	glDisable(GL_DEPTH_TEST);
+	gGLState.SetEnabled(GL_DEPTH_TEST, false);
 	// Now turn off depth writing and enable alpha blending (for meshes with alpha)
-	glDepthMask(GL_FALSE);
+	gGLState.SetDepthMask(false);
 	// Enable alpha blending on the color buffer
-	glEnable(GL_BLEND);
-	glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
-	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+	gGLState.SetEnabled(GL_BLEND, true);
+	gGLState.SetBlendEquation(GL_FUNC_ADD, GL_FUNC_ADD);
+	gGLState.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+
+	// The UI's pass data is just a screen-space view-projection
+	PassUniforms spritePass;
+	spritePass.mViewProj = Matrix4::CreateSimpleViewProj(mScreenWidth, mScreenHeight);
+	mPassUniforms->Push(&spritePass);
 
 	// Activate sprite shader/verts
 	mSpriteShader->SetActive();
@@ -181,8 +251,37 @@ void Renderer::Draw()
 		ui->Draw(mSpriteShader);
 	}
 
-	// Swap the buffers
-	SDL_GL_SwapWindow(mWindow);
+	mStateStats = gGLState.GetStats();
+	mTotalStateStats.mCalls += mStateStats.mCalls;
+	mTotalStateStats.mFiltered += mStateStats.mFiltered;
+	mNumFrames++;
+
+	gRenderBackend->Present();
+	mTotalCounts.Add(gRenderBackend->GetLastFrameCounts());
+	CheckBudget();
+	mDrawTicks += SDL_GetPerformanceCounter() - START;
+}
+
+void Renderer::CheckBudget()
+{
+	const RenderCounts& counts = gRenderBackend->GetLastFrameCounts();
+	// The main pass always has one
+	const unsigned int PORTAL_PASSES = static_cast<unsigned int>(mCullStats.size()) - 1;
+	auto isOver = [](unsigned int count, unsigned int most) { return most > 0 && count > most; };
+	if (!isOver(counts.mDrawCalls, mBudget.mDrawCalls) &&
+		!isOver(PORTAL_PASSES, mBudget.mPortalPasses) &&
+		!isOver(counts.mBlockBinds, mBudget.mBlockBinds))
+	{
+		return;
+	}
+
+	// Just the first one, the frames after it are usually the same
+	if (!mOverBudget)
+	{
+		SDL_Log("Renderer: frame %u over budget: %u draw calls, %u portal passes, %u block binds",
+				mNumFrames, counts.mDrawCalls, PORTAL_PASSES, counts.mBlockBinds);
+	}
+	mOverBudget = true;
 }
 
 void Renderer::AddMeshComp(MeshComponent* mesh, bool usesAlpha)
@@ -194,6 +293,10 @@ void Renderer::AddMeshComp(MeshComponent* mesh, bool usesAlpha)
 	else
 	{
 		mMeshCompsAlpha.emplace_back(mesh);
+		for (std::vector<DrawItem>& order : mAlphaOrders)
+		{
+			order.clear();
+		}
 	}
 }
 
@@ -208,6 +311,45 @@ void Renderer::RemoveMeshComp(const MeshComponent* mesh, bool usesAlpha)
 	{
 		auto iter = std::ranges::find(mMeshCompsAlpha, mesh);
 		mMeshCompsAlpha.erase(iter);
+		for (std::vector<DrawItem>& order : mAlphaOrders)
+		{
+			order.clear();
+		}
+	}
+}
+
+void Renderer::AddPortalMeshComp(PortalMeshComponent* mesh)
+{
+	mPortalMeshComps.emplace_back(mesh);
+}
+
+void Renderer::RemovePortalMeshComp(const MeshComponent* mesh)
+{
+	auto iter = std::ranges::find(mPortalMeshComps, mesh);
+	mPortalMeshComps.erase(iter);
+}
+
+bool Renderer::AddInstancedMeshComp(MeshComponent* mesh)
+{
+	InstanceBatch*& batch = mInstanceBatches[mesh->GetMesh()];
+	if (!batch)
+	{
+		batch = new InstanceBatch(mesh->GetMesh());
+	}
+	if (!batch->IsValid())
+	{
+		return false;
+	}
+	batch->AddComp(mesh);
+	return true;
+}
+
+void Renderer::RemoveInstancedMeshComp(const MeshComponent* mesh)
+{
+	auto iter = mInstanceBatches.find(mesh->GetMesh());
+	if (iter != mInstanceBatches.end())
+	{
+		iter->second->RemoveComp(mesh);
 	}
 }
 
@@ -281,11 +423,6 @@ bool Renderer::LoadShaders()
 		return false;
 	}
 
-	mSpriteShader->SetActive();
-	// Set the view-projection matrix
-	Matrix4 viewProj = Matrix4::CreateSimpleViewProj(mScreenWidth, mScreenHeight);
-	mSpriteShader->SetMatrixUniform("uViewProj", viewProj);
-
 	// Create basic mesh shader
 	mMeshShader = new Shader();
 	if (!mMeshShader->Load("Shaders/BasicMesh"))
@@ -293,11 +430,19 @@ bool Renderer::LoadShaders()
 		return false;
 	}
 
-	mMeshShader->SetActive();
-	// Set the view-projection matrix
+	// Default view-projection matrix
 	mView = Matrix4::Identity;
 	mProjection = Matrix4::CreateOrtho(mScreenWidth, mScreenHeight, 1000.0f, -1000.0f);
-	mMeshShader->SetMatrixUniform("uViewProj", mView * mProjection);
+
+	// Create instanced mesh shader
+	mInstancedShader = new Shader();
+	if (!mInstancedShader->Load("Shaders/InstancedMesh"))
+	{
+		return false;
+	}
+
+	mInstancedShader->SetActive();
+	mInstancedShader->SetIntUniform("uTextureArray", 0);
 
 	// Create portal shader
 	mPortalShader = new Shader();
@@ -310,7 +455,7 @@ bool Renderer::LoadShaders()
 	mPortalShader->SetIntUniform("uTexture", 0);
 	mPortalShader->SetIntUniform("uMask", 1);
 	mPortalShader->SetIntUniform("uRenderTarget", 2);
-	mPortalProjection = Matrix4::CreatePerspectiveFOV(1.22f, 512.0f, 512.0f, 10.0f, 100000.0f);
+	mPortalShader->SetVector2Uniform("uScreenSize", Vector2(mScreenWidth, mScreenHeight));
 
 	return true;
 }
@@ -329,43 +474,219 @@ void Renderer::CreateSpriteVerts()
 	mSpriteVerts = new VertexArray(vertices, 4, indices, 6);
 }
 
+void Renderer::InvalidatePortals()
+{
+	// A new portal can be at an old one's address
+	for (PortalPassState& state : mPortalPasses)
+	{
+		state.mLastPortal = nullptr;
+		state.mLastExit = nullptr;
+		std::ranges::fill(state.mQueryRecorded, false);
+		std::ranges::fill(state.mWasHidden, false);
+	}
+}
+
+void Renderer::ReadPortalQueries()
+{
+	// Each query is recorded once a frame, so it always stands for the same depth
+	static_assert(MAX_PORTAL_RECURSIONS <= 2);
+	for (PortalPassState& state : mPortalPasses)
+	{
+		for (int j = 0; j < 2; j++)
+		{
+			bool anySamples = true;
+			state.mWasHidden[j] = state.mQueryRecorded[j] &&
+								  gRenderBackend->GetQueryResult(state.mQueries[j], anySamples) &&
+								  !anySamples;
+			state.mQueryRecorded[j] = false;
+		}
+	}
+}
+
+void Renderer::DrawPortalPasses(Portal* portals[])
+{
+	PortalData* portalData[NUM_PORTALS] = {&mBluePortal, &mOrangePortal};
+	const unsigned int PORTAL_MASKS[NUM_PORTALS] = {BLUE_MASK, ORANGE_MASK};
+
+	// A portal pass only shows up where the stencil lets it, which is inside where
+	// its portal was drawn by the pass before (its footprint). So each pass culls
+	// against just that part of the screen.
+	Matrix4 invView = mView;
+	invView.Invert();
+	ScreenRect footprints[NUM_PORTALS];
+	bool footprintInFront[NUM_PORTALS];
+	ScreenRect rects[NUM_PORTALS];
+	bool recurse[NUM_PORTALS];
+	bool canReuse[NUM_PORTALS];
+	for (int k = 0; k < NUM_PORTALS; k++)
+	{
+		footprintInFront[k] = GetPortalFootprint(portals[k], mView * mProjection, footprints[k]);
+		rects[k] = footprints[k];
+		rects[k].Intersect(ScreenRect());
+		recurse[k] = mPortalPasses[k].mQueryIssued &&
+					 IsPortalWorthDrawing(portals[k], invView.GetTranslation(), rects[k]);
+
+		// Last frame's image only lines up if it was through these same portals
+		canReuse[k] = mPortalPasses[k].mLastPortal == portals[k] &&
+					  mPortalPasses[k].mLastExit == portals[1 - k];
+		mPortalPasses[k].mLastPortal = nullptr;
+		mPortalPasses[k].mLastExit = nullptr;
+	}
+
+	gGLState.SetEnabled(GL_CULL_FACE, true);
+	gGLState.SetEnabled(GL_CLIP_DISTANCE0, true);
+
+	int passesLeft = MAX_PORTAL_PASSES;
+	for (unsigned i = 0; i < MAX_PORTAL_RECURSIONS; i++)
+	{
+		for (int k = 0; k < NUM_PORTALS; k++)
+		{
+			PortalPassState& state = mPortalPasses[k];
+			if (!recurse[k])
+			{
+				continue;
+			}
+			// Last frame the GPU found the portal hidden at this depth, so skip the
+			// whole pass here instead of only its draws. (Coming back into view, it
+			// shows up a frame late.)
+			if (state.mWasHidden[i & 1] || passesLeft == 0)
+			{
+				recurse[k] = false;
+				continue;
+			}
+			passesLeft--;
+			const Matrix4 VIEW_PROJ = portalData[k]->mView * mProjection;
+
+			// Every other portal still recursing gets its next pass before this one
+			int othersPending = 0;
+			for (int other = 0; other < NUM_PORTALS; other++)
+			{
+				if (other != k && recurse[other])
+				{
+					othersPending++;
+				}
+			}
+
+			// The deepest pass (by recursion or by budget) fills the portal it sees
+			// with last frame's image of this pass (which had last frame's deeper
+			// ones in it), stretched from where this pass was on screen onto where
+			// that portal is
+			state.mReuse = false;
+			if (i + 1 == MAX_PORTAL_RECURSIONS || passesLeft <= othersPending)
+			{
+				ScreenRect quadFootprint;
+				bool quadInFront = GetPortalFootprint(portals[k], VIEW_PROJ, quadFootprint);
+				state.mReuse = canReuse[k] && quadInFront;
+				state.mReuseFrom = state.mLastFootprint;
+				state.mReuseTo = quadFootprint;
+				if (footprintInFront[k])
+				{
+					state.mLastPortal = portals[k];
+					state.mLastExit = portals[1 - k];
+					state.mLastFootprint = footprints[k];
+				}
+			}
+
+			// Queries ping-pong, since the one this pass waits on can't also be
+			// recorded into. The other portal is the exit here, so it isn't drawn.
+			const int OTHER = 1 - k;
+			Portal* exitPortal = portals[OTHER];
+			state.mRecordQuery = state.mQueries[(i + 1) & 1];
+			state.mQueryIssued = false;
+			mPortalPasses[OTHER].mRecordQuery = 0;
+			mPortalPasses[OTHER].mReuse = false;
+
+			// This portal's pass at this depth last frame is the closest view
+			std::vector<DrawItem>& alphaOrder = mAlphaOrders[1 + k * MAX_PORTAL_RECURSIONS + i];
+
+			// Whether the portal is hidden behind something only the GPU knows, so
+			// it skips this pass itself (without waiting on the CPU for it). Without
+			// conditional rendering (WebGL), the pass always runs.
+			gRenderBackend->BeginConditionalRender(state.mQueries[i & 1]);
+			Draw3DScene(portalData[k]->mView, mProjection, static_cast<int>(mScreenWidth),
+						static_cast<int>(mScreenHeight), alphaOrder, exitPortal, portalData[k],
+						PORTAL_MASKS[k] | i, rects[k]);
+			gRenderBackend->EndConditionalRender();
+			state.mReuse = false;
+
+			// The next recursion sees the portal through itself, from this pass's camera
+			footprintInFront[k] = GetPortalFootprint(portals[k], VIEW_PROJ, footprints[k]);
+			rects[k].Intersect(footprints[k]);
+			recurse[k] = state.mQueryIssued &&
+						 IsPortalWorthDrawing(portals[k], portalData[k]->mCameraPos, rects[k]);
+
+			// Recalculate the view for the next recursion
+			PortalViewRecurse(*portalData[k], portals[k], exitPortal);
+		}
+	}
+
+	for (PortalPassState& state : mPortalPasses)
+	{
+		state.mRecordQuery = 0;
+	}
+}
+
+bool Renderer::IsPortalWorthDrawing(Portal* portal, const Vector3& viewerPos,
+									const ScreenRect& rect) const
+{
+	// From behind it's only visible through the wall it's on
+	Transform& xform = portal->GetTransform();
+	if (Vector3::Dot(viewerPos - xform.GetPosition(), xform.GetForward()) <= 0.0f)
+	{
+		return false;
+	}
+
+	if (rect.IsEmpty())
+	{
+		return false;
+	}
+	float pixels = (rect.mMaxX - rect.mMinX) * (rect.mMaxY - rect.mMinY) * mScreenWidth *
+				   mScreenHeight * 0.25f;
+	return pixels >= MIN_PORTAL_PIXELS;
+}
+
 void Renderer::Draw3DScene(const Matrix4& view, const Matrix4& projection, int viewWidth,
-						   int viewHeight, class Actor* portal, PortalData* portalData,
-						   unsigned int stencilMask)
+						   int viewHeight, std::vector<DrawItem>& alphaOrder, class Actor* portal,
+						   PortalData* portalData, unsigned int stencilMask,
+						   const ScreenRect& screenRect)
 {
 	// Set viewport size based on scale
-	glViewport(0, 0, viewWidth, viewHeight);
+	gRenderBackend->SetViewport(viewWidth, viewHeight);
 
 	// Set the clear color to light grey
-	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	gRenderBackend->SetClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	// Clear the color/depth buffer
-	glDepthMask(GL_TRUE);
+	gGLState.SetDepthMask(true);
 	if (!portal)
 	{
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+		gRenderBackend->Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 	}
 	else
 	{
-		glClear(GL_DEPTH_BUFFER_BIT);
+		gRenderBackend->Clear(GL_DEPTH_BUFFER_BIT);
 	}
 
 	// Enable depth buffering/disable alpha blend
-	glEnable(GL_DEPTH_TEST);
-	glDisable(GL_BLEND);
-	glEnable(GL_STENCIL_TEST);
-	glStencilMask(0xFF);
-	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+	gGLState.SetEnabled(GL_DEPTH_TEST, true);
+	gGLState.SetEnabled(GL_BLEND, false);
+	gGLState.SetEnabled(GL_STENCIL_TEST, true);
+	gGLState.SetStencilMask(0xFF);
+	gGLState.SetStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 	if (!portal)
 	{
-		glStencilFunc(GL_ALWAYS, 0, 0);
+		gGLState.SetStencilFunc(GL_ALWAYS, 0, 0);
 	}
 	else
 	{
-		glStencilFunc(GL_EQUAL, static_cast<int>(stencilMask), stencilMask);
+		gGLState.SetStencilFunc(GL_EQUAL, static_cast<int>(stencilMask), stencilMask);
 	}
 	// Set the mesh shader active
 	mMeshShader->SetActive();
 
+	Matrix4 viewProj = view * projection;
+	Frustum frustum(viewProj, screenRect);
+	CullStats& cullStats = mCullStats.emplace_back();
+
 	Vector4 plane;
 	if (portal)
 	{
@@ -375,94 +696,139 @@ void Renderer::Draw3DScene(const Matrix4& view, const Matrix4& projection, int v
 		Vector3 planePos = portal->GetTransform().GetPosition();
 		float d = -Vector3::Dot(planeNormal, planePos) - 5.0f;
 		plane = Vector4(planeNormal, d);
-		mMeshShader->SetVector4Uniform("uClipPlane", plane);
-		// Update view-projection matrix
-		mMeshShader->SetMatrixUniform("uViewProj", view * projection);
+		frustum.AddPlane(plane);
 	}
-	else
+
+	// Shared by every shader this pass uses
+	PassUniforms pass;
+	pass.mViewProj = viewProj;
+	pass.mClipPlane = plane;
+	mPassUniforms->Push(&pass);
+
+	// Everything this pass draws, culled and in draw order
+	mQueue.Clear();
+	mQueue.Gather(mMeshComps, 0, frustum, viewProj, cullStats);
+	mQueue.Sort();
+	mQueue.GatherAlpha(alphaOrder, mMeshCompsAlpha, frustum, viewProj, cullStats);
+
+	// Every draw's world transform goes up at once, each draw just indexes its own
+	mStaticGeometry.AddDrawData(*mDrawUniforms);
+	for (const DrawItem& item : mQueue.GetItems(RenderQueue::Layer::Opaque))
+	{
+		item.mComp->AddDrawData(*mDrawUniforms);
+	}
+	for (const DrawItem& item : mQueue.GetItems(RenderQueue::Layer::Alpha))
+	{
+		item.mComp->AddDrawData(*mDrawUniforms);
+	}
+	for (PortalMeshComponent* pmc : mPortalMeshComps)
 	{
-		// Update view-projection matrix
-		mMeshShader->SetMatrixUniform("uViewProj", view * projection);
+		pmc->AddDrawData(*mDrawUniforms);
+	}
+	mDrawUniforms->Upload();
+
+	// Draw the static level geometry, then instanced mesh components, first.
+	// They hide most of everything else.
+	mStaticGeometry.Draw(mMeshShader, *mDrawUniforms, frustum, cullStats);
+	if (!mInstanceBatches.empty())
+	{
+		mInstancedShader->SetActive();
+		for (const auto& [mesh, batch] : mInstanceBatches)
+		{
+			if (batch->IsValid())
+			{
+				batch->Draw(frustum, cullStats);
+			}
+		}
+		mMeshShader->SetActive();
 	}
 
 	// Draw mesh components
-	for (auto mc : mMeshComps)
+	for (const DrawItem& item : mQueue.GetItems(RenderQueue::Layer::Opaque))
 	{
-		mc->Draw(mMeshShader);
+		item.mComp->Draw(mMeshShader, *mDrawUniforms);
 	}
 
 	// Now turn off depth writing and enable alpha blending (for meshes with alpha)
-	glDepthMask(GL_FALSE);
+	gGLState.SetDepthMask(false);
 	// Enable alpha blending on the color buffer
-	glEnable(GL_BLEND);
-	glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
-	glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+	gGLState.SetEnabled(GL_BLEND, true);
+	gGLState.SetBlendEquation(GL_FUNC_ADD, GL_FUNC_ADD);
+	gGLState.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+	// Alpha meshes are seen from both sides
+	gGLState.SetEnabled(GL_CULL_FACE, false);
+
+	// Portal surfaces first (other alpha meshes, like their outlines, go over
+	// them), except the one this pass looks out of. Each marks where it is in
+	// the stencil for the portal passes.
+	bool drewPortal = false;
+	for (PortalMeshComponent* pmc : mPortalMeshComps)
+	{
+		Portal* portalActor = pmc->GetPortal();
+		if (portalActor == portal)
+		{
+			continue;
+		}
+		cullStats.mTested++;
+		if (!pmc->IsVisible(frustum))
+		{
+			cullStats.mCulled++;
+			continue;
+		}
 
-	// Sort alpha objects based on depth.
-	// This is not perfect for lasers because it uses the depth of the owner
-	Matrix4 viewProj = view * projection;
-	std::ranges::stable_sort(mMeshCompsAlpha,
-							 [&viewProj](const MeshComponent* a, const MeshComponent* b) {
-								 // Get depth of a
-								 Vector3 aPos = a->GetOwner()->GetTransform().GetPosition();
-								 Vector3 aProj = Vector3::TransformWithPerspDiv(aPos, viewProj);
-								 float aDepth = aProj.z;
-
-								 // Get depth of b
-								 Vector3 bPos = b->GetOwner()->GetTransform().GetPosition();
-								 Vector3 bProj = Vector3::TransformWithPerspDiv(bPos, viewProj);
-								 float bDepth = bProj.z;
-								 return aDepth > bDepth;
-							 });
-
-	// Draw mesh components with alpha
-	glDisable(GL_CULL_FACE);
-	for (auto mc : mMeshCompsAlpha)
-	{
-		PortalMeshComponent* pmc = dynamic_cast<PortalMeshComponent*>(mc);
-		if (mc->GetOwner() != portal || !pmc)
+		if (portal)
 		{
-			if (pmc)
-			{
-				Portal* portalActor = dynamic_cast<Portal*>(mc->GetOwner());
-				if (portal)
-				{
-					glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
-				}
-				else
-				{
-					unsigned int portalMask = BLUE_MASK;
-					if (portalActor != mGame->GetBluePortal())
-					{
-						portalMask = ORANGE_MASK;
-					}
-					glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-					glStencilFunc(GL_ALWAYS, static_cast<int>(portalMask), portalMask);
-				}
-				mPortalShader->SetActive();
-				mPortalShader->SetVector4Uniform("uClipPlane", plane);
-				mPortalShader->SetMatrixUniform("uViewProj", view * projection);
-				mc->Draw(mPortalShader);
-				mMeshShader->SetActive();
-				if (portal)
-				{
-					glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-				}
-				else
-				{
-					glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-					glStencilFunc(GL_ALWAYS, 0, 0);
-				}
-			}
-			else
-			{
-				mc->Draw(mMeshShader);
-			}
+			gGLState.SetStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+		}
+		else
+		{
+			unsigned int portalMask = portalActor->IsBlue() ? BLUE_MASK : ORANGE_MASK;
+			gGLState.SetStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+			gGLState.SetStencilFunc(GL_ALWAYS, static_cast<int>(portalMask), portalMask);
+		}
+		mPortalShader->SetActive();
+		PortalPassState& state = mPortalPasses[portalActor->IsBlue() ? 0 : 1];
+		mPortalShader->SetUniform(REUSE, state.mReuse ? 1 : 0);
+		if (state.mReuse)
+		{
+			const ScreenRect& from = state.mReuseFrom;
+			const ScreenRect& to = state.mReuseTo;
+			mPortalShader->SetUniform(REUSE_FROM,
+									  Vector4(from.mMinX, from.mMinY, from.mMaxX, from.mMaxY));
+			mPortalShader->SetUniform(REUSE_TO, Vector4(to.mMinX, to.mMinY, to.mMaxX, to.mMaxY));
+			mPortalTarget->SetActive(2);
 		}
+		if (state.mRecordQuery)
+		{
+			gRenderBackend->BeginQuery(state.mRecordQuery);
+		}
+		pmc->Draw(mPortalShader, *mDrawUniforms);
+		if (state.mRecordQuery)
+		{
+			gRenderBackend->EndQuery();
+			state.mQueryIssued = true;
+			state.mQueryRecorded[state.mRecordQuery == state.mQueries[0] ? 0 : 1] = true;
+		}
+		drewPortal = true;
+	}
+	if (drewPortal)
+	{
+		mMeshShader->SetActive();
+		gGLState.SetStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+		if (!portal)
+		{
+			gGLState.SetStencilFunc(GL_ALWAYS, 0, 0);
+		}
+	}
+
+	// Draw mesh components with alpha, back to front
+	for (const DrawItem& item : mQueue.GetItems(RenderQueue::Layer::Alpha))
+	{
+		item.mComp->Draw(mMeshShader, *mDrawUniforms);
 	}
 
-	glEnable(GL_CULL_FACE);
-	glDisable(GL_STENCIL_TEST);
+	gGLState.SetEnabled(GL_CULL_FACE, true);
+	gGLState.SetEnabled(GL_STENCIL_TEST, false);
 }
 
 Vector3 Renderer::Unproject(const Vector3& screenPoint) const
@@ -478,6 +844,18 @@ Vector3 Renderer::Unproject(const Vector3& screenPoint) const
 	return Vector3::TransformWithPerspDiv(deviceCoord, unprojection);
 }
 
+bool Renderer::GetPortalFootprint(const Portal* portal, const Matrix4& viewProj,
+								  ScreenRect& outRect)
+{
+	const PortalMeshComponent* pmc = portal->GetComponent<PortalMeshComponent>();
+	if (!pmc || !pmc->HasWorldBounds())
+	{
+		outRect = ScreenRect();
+		return false;
+	}
+	return ScreenRect::FromBox(pmc->GetWorldBox(), viewProj, outRect);
+}
+
 void Renderer::PortalViewRecurse(PortalData& portalData, Portal* entryPortal, Portal* exitPortal)
 {
 	// 1. Transform cam pos through the portals (w = 1 for positions)
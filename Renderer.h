@@ -5,6 +5,11 @@
 #include <SDL3/SDL.h>
 #include "Math.h"
 #include "Mesh.h"
+#include "Frustum.h"
+#include "RenderQueue.h"
+#include "StaticGeometry.h"
+#include "GLState.h"
+#include "RenderBackend.h"
 
 // Data for portals
 struct PortalData
@@ -16,26 +21,59 @@ struct PortalData
 	Vector3 mCameraUp;
 };
 
+// How many mesh components one Draw3DScene call looked at and how many it culled
+struct CullStats
+{
+	unsigned int mTested = 0;
+	unsigned int mCulled = 0;
+};
+
+// The most a frame may ask for before a headless run counts as a regression
+// (see Main.cpp). 0 is no limit.
+struct RenderBudget
+{
+	unsigned int mDrawCalls = 0;
+	// Every scene pass but the main one
+	unsigned int mPortalPasses = 0;
+	unsigned int mBlockBinds = 0;
+};
+
+// Decides what's drawn and how (culling, sorting, portal passes), and has its
+// RenderBackend draw it
 class Renderer
 {
 public:
-	Renderer(class Game* game);
+	Renderer(class Game* game, RenderBackendType backendType = RenderBackendType::GL);
 
 	bool Initialize(float width, float height);
 	void Shutdown();
 	void UnloadData();
 
 	SDL_Window* GetWindow() const { return mWindow; }
+	RenderBackend* GetBackend() const { return gRenderBackend; }
 
 	void Draw();
 
 	void AddMeshComp(class MeshComponent* mesh, bool usesAlpha);
 	void RemoveMeshComp(const class MeshComponent* mesh, bool usesAlpha);
 
+	// Returns false if the component's mesh can't be instanced
+	bool AddInstancedMeshComp(class MeshComponent* mesh);
+	void RemoveInstancedMeshComp(const class MeshComponent* mesh);
+	void AddStaticMeshComp(class MeshComponent* mesh) { mStaticGeometry.AddComp(mesh); }
+	void RemoveStaticMeshComp(const class MeshComponent* mesh) { mStaticGeometry.RemoveComp(mesh); }
+	// Bakes the static mesh components (once the level is loaded)
+	void BuildStaticGeometry() { mStaticGeometry.Build(); }
+
+	// Portal surfaces are drawn on their own (not with the other alpha meshes)
+	void AddPortalMeshComp(class PortalMeshComponent* mesh);
+	void RemovePortalMeshComp(const class MeshComponent* mesh);
+
 	void AddUIComp(class UIComponent* comp);
 	void RemoveUIComp(const class UIComponent* comp);
 
 	class Texture* GetTexture(const std::string& fileName);
+	class MeshBuffer* GetMeshBuffer() const { return mMeshBuffer; }
 	Mesh* GetMesh(const std::string& fileName);
 
 	void SetViewMatrix(const Matrix4& view) { mView = view; }
@@ -48,13 +86,42 @@ public:
 
 	PortalData& GetBluePortal() { return mBluePortal; }
 	PortalData& GetOrangePortal() { return mOrangePortal; }
+	// Called whenever a portal is shot or removed, so nothing from before is reused
+	void InvalidatePortals();
+
+	// One entry per scene pass last frame: the main pass, then each portal pass
+	// in the order they were drawn
+	const std::vector<CullStats>& GetCullStats() const { return mCullStats; }
+	// GL state changes last frame, and how many were skipped as redundant
+	const GLStateStats& GetStateStats() const { return mStateStats; }
+	// Draws, state changes, uniform uploads and block binds that reached the backend last frame
+	const RenderCounts& GetRenderCounts() const { return gRenderBackend->GetLastFrameCounts(); }
+
+	void SetBudget(const RenderBudget& budget) { mBudget = budget; }
+	// True once any frame went over the budget
+	bool IsOverBudget() const { return mOverBudget; }
 
 private:
 	bool LoadShaders();
 	void CreateSpriteVerts();
+	// alphaOrder is this pass's alpha draw order (see mAlphaOrders)
 	void Draw3DScene(const Matrix4& view, const Matrix4& projection, int viewWidth, int viewHeight,
-					 class Actor* portal = nullptr, PortalData* portalData = nullptr,
-					 unsigned int stencilMask = 0);
+					 std::vector<DrawItem>& alphaOrder, class Actor* portal = nullptr,
+					 PortalData* portalData = nullptr, unsigned int stencilMask = 0,
+					 const ScreenRect& screenRect = ScreenRect());
+	// Reads whichever of last frame's portal queries the GPU is done with
+	void ReadPortalQueries();
+	// Compares the frame that was just presented against mBudget
+	void CheckBudget();
+	// The blue and orange recursions, each only as deep as its portal stays visible
+	void DrawPortalPasses(class Portal* portals[]);
+	// False if a pass seeing portal from viewerPos, inside rect, wouldn't show anything
+	bool IsPortalWorthDrawing(class Portal* portal, const Vector3& viewerPos,
+							  const ScreenRect& rect) const;
+	// Where portal's quad lands on screen under viewProj (false if that's unknown,
+	// because it's partly behind the camera)
+	static bool GetPortalFootprint(const class Portal* portal, const Matrix4& viewProj,
+								   ScreenRect& outRect);
 	static void PortalViewRecurse(PortalData& portalData, class Portal* entryPortal,
 								  class Portal* exitPortal);
 
@@ -67,30 +134,61 @@ private:
 	std::vector<class MeshComponent*> mMeshComps;
 	// All mesh components w/ alpha
 	std::vector<class MeshComponent*> mMeshCompsAlpha;
+	std::vector<class PortalMeshComponent*> mPortalMeshComps;
+	// Instanced mesh components, by mesh
+	std::unordered_map<Mesh*, class InstanceBatch*> mInstanceBatches;
+	// Mesh components that never move
+	StaticGeometry mStaticGeometry;
 	// UI components to draw
 	std::vector<class UIComponent*> mUIComps;
 
+	std::vector<CullStats> mCullStats;
+	GLStateStats mStateStats;
+	// Every frame's, logged on shutdown
+	GLStateStats mTotalStateStats;
+	RenderCounts mTotalCounts;
+	// Time spent in Draw (including the swap, which waits on vsync with GL)
+	Uint64 mDrawTicks = 0;
+	unsigned int mNumFrames = 0;
+	RenderBudget mBudget;
+	bool mOverBudget = false;
+	// Reused by every pass
+	RenderQueue mQueue;
+
 	// Game
 	class Game* mGame;
 
 	// Sprite shader
 	class Shader* mSpriteShader;
+	// Every mesh's vertices/indices
+	class MeshBuffer* mMeshBuffer;
+	// PassData and DrawData uniform blocks, streamed to the shaders
+	class UniformRing* mPassUniforms;
+	class UniformRing* mDrawUniforms;
 	// Sprite vertex array
 	class VertexArray* mSpriteVerts;
 
 	// Mesh shader
 	class Shader* mMeshShader;
+	// Mesh shader for instance batches
+	class Shader* mInstancedShader;
 	// Portal shader
 	class Shader* mPortalShader;
 
+	// Layout of the PassData block (row major)
+	struct PassUniforms
+	{
+		Matrix4 mViewProj;
+		Vector4 mClipPlane;
+	};
+
 	// View/projection for 3D shaders
 	Matrix4 mView;
 	Matrix4 mProjection;
 
-	// Window
+	RenderBackendType mBackendType;
+	// Window (the backend's)
 	SDL_Window* mWindow;
-	// OpenGL context
-	SDL_GLContext mContext;
 
 	// Width/height of screem
 	float mScreenWidth;
@@ -98,9 +196,54 @@ private:
 
 	PortalData mBluePortal;
 	PortalData mOrangePortal;
-	Matrix4 mPortalProjection;
 
 	static constexpr unsigned int BLUE_MASK = 64;
 	static constexpr unsigned int ORANGE_MASK = 128;
-	static constexpr unsigned int MAX_PORTAL_RECURSIONS = 6;
+	// Deeper than this is filled from last frame
+	static constexpr unsigned int MAX_PORTAL_RECURSIONS = 2;
+	// Portal passes drawn per frame at most, across both portals. Less than the
+	// recursions could take, so a portal's last pass within it fills the rest
+	// from last frame.
+	static constexpr int MAX_PORTAL_PASSES = 3;
+	// Smaller than this on screen (in pixels) isn't worth another pass
+	static constexpr float MIN_PORTAL_PIXELS = 64.0f;
+
+	struct PortalPassState
+	{
+		// Two occlusion queries: the portal's quad in the pass before, and in the
+		// current pass for the next one
+		unsigned int mQueries[2] = {};
+		// What the current pass records the quad into (0 for nothing), and whether
+		// it did (it could be culled)
+		unsigned int mRecordQuery = 0;
+		bool mQueryIssued = false;
+		// Whether each query was recorded this frame, and whether last frame's
+		// result (if the GPU had it by the start of this frame) was hidden
+		bool mQueryRecorded[2] = {};
+		bool mWasHidden[2] = {};
+
+		// Whether the current pass fills the quad from mPortalTarget, stretching
+		// mReuseFrom (on last frame's screen) onto mReuseTo
+		bool mReuse = false;
+		ScreenRect mReuseFrom;
+		ScreenRect mReuseTo;
+		// Where last frame's deepest pass was on screen, if it looked into this
+		// portal and out of mLastExit
+		const class Portal* mLastPortal = nullptr;
+		const class Portal* mLastExit = nullptr;
+		ScreenRect mLastFootprint;
+	};
+	// Blue then orange
+	static constexpr int NUM_PORTALS = 2;
+	PortalPassState mPortalPasses[NUM_PORTALS];
+
+	// Each scene pass's alpha draw order last frame, the next frame's starting
+	// point: the main pass, then each portal's by recursion depth. Passes that
+	// get skipped don't shift the others onto another view's order.
+	std::vector<DrawItem> mAlphaOrders[1 + NUM_PORTALS * MAX_PORTAL_RECURSIONS];
+
+	// Last frame (without UI), scaled down
+	class Texture* mPortalTarget = nullptr;
+	unsigned int mPortalFramebuffer = 0;
+	static constexpr int PORTAL_TARGET_SIZE = 512;
 };
@@ -0,0 +1,50 @@
+#include "RigidBodyComponent.h"
+#include "Actor.h"
+#include "Game.h"
+#include "CollisionComponent.h"
+#include "PhysicsWorld.h"
+
+RigidBodyComponent::RigidBodyComponent(class Actor* owner)
+: Component(owner)
+{
+	// Asleep, so the physics world doesn't need to know about it yet
+	mColl = mOwner->GetComponent<CollisionComponent>();
+}
+
+RigidBodyComponent::~RigidBodyComponent()
+{
+	gGame.GetPhysicsWorld()->RemoveBody(this);
+}
+
+void RigidBodyComponent::Wake()
+{
+	mRestTime = 0.0f;
+	if (!mIsAwake)
+	{
+		mIsAwake = true;
+		gGame.GetPhysicsWorld()->WakeBody(this);
+	}
+}
+
+void RigidBodyComponent::Push(const Vector3& velocity)
+{
+	Wake();
+	const float SPEED_SQ = velocity.LengthSq();
+	if (SPEED_SQ > 0.0f)
+	{
+		// How much of velocity the body already has
+		float along = Vector3::Dot(mVelocity, velocity) / SPEED_SQ;
+		if (along < 1.0f)
+		{
+			mVelocity += velocity * (1.0f - along);
+		}
+	}
+}
+
+void RigidBodyComponent::Sleep()
+{
+	// PhysicsWorld drops it from the awake bodies at the end of the step
+	mIsAwake = false;
+	mVelocity = Vector3::Zero;
+	mRestTime = 0.0f;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Component.h"
+#include "Math.h"
+#include <functional>
+
+class CollisionComponent;
+struct Contact;
+struct PortalPolicy;
+
+// Dynamic body moved by the PhysicsWorld (gravity, sweeps, contacts). Needs a
+// CollisionComponent on the same actor. Bodies start asleep, where they cost
+// nothing, and stay that way until woken.
+class RigidBodyComponent : public Component
+{
+public:
+	const Vector3& GetVelocity() const { return mVelocity; }
+	void SetVelocity(const Vector3& velocity) { mVelocity = velocity; }
+	void AddVelocity(const Vector3& velocity) { mVelocity += velocity; }
+
+	// Terminal speed (0 for none)
+	void SetMaxSpeed(float maxSpeed) { mMaxSpeed = maxSpeed; }
+
+	bool IsAwake() const { return mIsAwake; }
+	void Wake();
+	// Wakes the body and makes it move at least as fast as velocity in
+	// velocity's direction (like being shoved)
+	void Push(const Vector3& velocity);
+	// Stops the body where it is (its velocity is cleared)
+	void Sleep();
+
+	// Called for every collider the body was pushed out of, before its velocity
+	// into that collider is removed
+	void SetOnContact(const std::function<void(const Contact&)>& onContact)
+	{
+		mOnContact = onContact;
+	}
+
+	// Lets the body go through portals right after it moves
+	void SetPortalPolicy(PortalPolicy* policy) { mPortalPolicy = policy; }
+
+	CollisionComponent* GetCollision() const { return mColl; }
+
+protected:
+	RigidBodyComponent(class Actor* owner);
+	~RigidBodyComponent() override;
+	friend class Actor;
+	friend class PhysicsWorld;
+
+private:
+	CollisionComponent* mColl = nullptr;
+	Vector3 mVelocity = Vector3::Zero;
+	float mMaxSpeed = 0.0f;
+	std::function<void(const Contact&)> mOnContact;
+	PortalPolicy* mPortalPolicy = nullptr;
+
+	// Kept up by PhysicsWorld
+	bool mIsAwake = false;
+	bool mIsInAwakeList = false;
+	// How long the body has been nearly still
+	float mRestTime = 0.0f;
+	// Index into the step's awake bodies, used to build islands
+	int mStepIndex = -1;
+};
@@ -1,5 +1,4 @@
 #include "SegmentCast.h"
-#include <algorithm>
 #include "CollisionComponent.h"
 #include "Actor.h"
 
@@ -36,41 +35,24 @@ bool Contains(const Vector3& min, const Vector3& max, const Vector3& point)
 	return !outside;
 }
 
-// Helper function for Intersect
-bool TestSidePlane(float start, float end, float negd, const Vector3& norm,
-				   std::vector<std::pair<float, Vector3>>& out)
+// Helper function for IntersectBox, returns t where the segment crosses the plane
+bool TestSidePlane(float start, float end, float negd, float& outT)
 {
 	float denom = end - start;
 	if (Math::NearlyZero(denom))
 	{
 		return false;
 	}
-	else
-	{
-		float numer = -start + negd;
-		float t = numer / denom;
-		// Test that t is within bounds
-		if (t >= 0.0f && t <= 1.0f)
-		{
-			out.emplace_back(t, norm);
-			return true;
-		}
-		else
-		{
-			return false;
-		}
-	}
+
+	float numer = -start + negd;
+	outT = numer / denom;
+	// Test that t is within bounds
+	return outT >= 0.0f && outT <= 1.0f;
 }
 
-bool Intersect(const LineSegment& l, const CollisionComponent* cc, float& outT, Vector3& outNorm)
+bool IntersectBox(const LineSegment& l, const Vector3& min, const Vector3& max, float& outT,
+				  Vector3& outNorm)
 {
-	// Vector to save all possible t values, and normals for those sides
-	static std::vector<std::pair<float, Vector3>> tValues;
-	tValues.clear();
-
-	Vector3 min = cc->GetMin();
-	Vector3 max = cc->GetMax();
-
 	// If the segment starts in the box, then return t = 0 and no normal
 	if (Contains(min, max, l.mStart))
 	{
@@ -79,35 +61,36 @@ bool Intersect(const LineSegment& l, const CollisionComponent* cc, float& outT,
 		return true;
 	}
 
-	// Test the x planes
-	TestSidePlane(l.mStart.x, l.mEnd.x, min.x, Vector3::NegUnitX, tValues);
-	TestSidePlane(l.mStart.x, l.mEnd.x, max.x, Vector3::UnitX, tValues);
-	// Test the y planes
-	TestSidePlane(l.mStart.y, l.mEnd.y, min.y, Vector3::NegUnitY, tValues);
-	TestSidePlane(l.mStart.y, l.mEnd.y, max.y, Vector3::UnitY, tValues);
-	// Test the z planes
-	TestSidePlane(l.mStart.z, l.mEnd.z, min.z, Vector3::NegUnitZ, tValues);
-	TestSidePlane(l.mStart.z, l.mEnd.z, max.z, Vector3::UnitZ, tValues);
-
-	// Sort the t values in ascending order
-	std::ranges::sort(tValues,
-					  [](const std::pair<float, Vector3>& a, const std::pair<float, Vector3>& b) {
-						  return a.first < b.first;
-					  });
-	// Test if the box contains any of these points of intersection
-	for (auto& t : tValues)
+	// Each side plane as (start, end, plane) along its axis
+	const float STARTS[6] = {l.mStart.x, l.mStart.x, l.mStart.y, l.mStart.y, l.mStart.z, l.mStart.z};
+	const float ENDS[6] = {l.mEnd.x, l.mEnd.x, l.mEnd.y, l.mEnd.y, l.mEnd.z, l.mEnd.z};
+	const float PLANES[6] = {min.x, max.x, min.y, max.y, min.z, max.z};
+	const Vector3 NORMALS[6] = {Vector3::NegUnitX, Vector3::UnitX, Vector3::NegUnitY,
+								Vector3::UnitY,	   Vector3::NegUnitZ, Vector3::UnitZ};
+
+	// Keep the earliest point of intersection that's actually on the box.
+	// Strict < so ties go to the first plane tested (same as a stable sort).
+	bool found = false;
+	float closestT = Math::Infinity;
+	for (int i = 0; i < 6; i++)
 	{
-		Vector3 point = l.PointOnSegment(t.first);
-		if (Contains(min, max, point))
+		float t = 0.0f;
+		if (TestSidePlane(STARTS[i], ENDS[i], PLANES[i], t) && t < closestT &&
+			Contains(min, max, l.PointOnSegment(t)))
 		{
-			outT = t.first;
-			outNorm = t.second;
-			return true;
+			closestT = t;
+			outNorm = NORMALS[i];
+			found = true;
 		}
 	}
 
-	// None of the intersections are within bounds of box
-	return false;
+	outT = closestT;
+	return found;
+}
+
+bool Intersect(const LineSegment& l, const CollisionComponent* cc, float& outT, Vector3& outNorm)
+{
+	return IntersectBox(l, cc->GetMin(), cc->GetMax(), outT, outNorm);
 }
 
 bool SegmentCast(const std::vector<class Actor*>& actors, const LineSegment& l, CastInfo& outInfo,
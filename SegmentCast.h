@@ -25,6 +25,12 @@ struct CastInfo
 	class Actor* mActor = nullptr;
 };
 
+// Returns true if the segment hits the box, in which case outT is the first t along
+// the segment on the box and outNorm that side's normal (t = 0 and no normal if the
+// segment starts inside)
+bool IntersectBox(const LineSegment& l, const Vector3& min, const Vector3& max, float& outT,
+				  Vector3& outNorm);
+
 // Returns true if the segment intersects with any of the Actors in the vector,
 // in which case outInfo is populated with the relevant information
 bool SegmentCast(const std::vector<class Actor*>& actors, const LineSegment& l, CastInfo& outInfo,
@@ -1,153 +1,227 @@
 #include "Shader.h"
 #include "Texture.h"
+#include "GLState.h"
+#include "RenderBackend.h"
 #include <SDL3/SDL.h>
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+	const Uniform<int> DRAW_INDEX("uDrawIndex");
+} // namespace
 
 Shader::Shader()
-: mVertexShader(0)
-, mFragShader(0)
-, mShaderProgram(0)
+: mShaderProgram(0)
 {
 }
 
 bool Shader::Load(const std::string& name)
 {
-	// Compile vertex and pixel shaders
-	if (!CompileShader(name + ".vert", GL_VERTEX_SHADER, mVertexShader) ||
-		!CompileShader(name + ".frag", GL_FRAGMENT_SHADER, mFragShader))
+	std::string vertSource;
+	std::string fragSource;
+	if (!ReadSource(name + ".vert", vertSource) || !ReadSource(name + ".frag", fragSource))
 	{
 		return false;
 	}
 
-	// Now create a shader program that
-	// links together the vertex/frag shaders
-	mShaderProgram = glCreateProgram();
-	glAttachShader(mShaderProgram, mVertexShader);
-	glAttachShader(mShaderProgram, mFragShader);
-	glLinkProgram(mShaderProgram);
+	// Compile the vertex/pixel shaders and link them into a program
+	mShaderProgram = gRenderBackend->CreateProgram(vertSource, fragSource, name);
+	if (!mShaderProgram)
+	{
+		return false;
+	}
 
-	// Verify that the program linked successfully
-	return IsValidProgram();
+	ReflectUniforms();
+	return true;
 }
 
 void Shader::Unload()
 {
-	// Delete the program/shaders
-	glDeleteProgram(mShaderProgram);
-	glDeleteShader(mVertexShader);
-	glDeleteShader(mFragShader);
+	// Delete the program
+	gRenderBackend->DeleteProgram(mShaderProgram);
+	gGLState.OnProgramDeleted(mShaderProgram);
 
 	mShaderProgram = 0;
-	mVertexShader = 0;
-	mFragShader = 0;
+	mUniforms.clear();
 }
 
 void Shader::SetActive() const
 {
 	// Set this program as the active one
-	glUseProgram(mShaderProgram);
+	gGLState.UseProgram(mShaderProgram);
 }
 
-void Shader::SetMatrixUniform(const char* name, const Matrix4& matrix) const
+void Shader::SetUniform(const Uniform<Matrix4>& uniform, const Matrix4& matrix)
 {
-	// Find the uniform by this name
-	GLint loc = glGetUniformLocation(mShaderProgram, name);
-	// Send the matrix data to the uniform
-	glUniformMatrix4fv(loc, 1, GL_TRUE, matrix.GetAsFloatPtr());
+	GLint loc = UpdateUniform(uniform.GetID(), matrix.GetAsFloatPtr(), sizeof(float) * 16);
+	if (loc != -1)
+	{
+		// Send the matrix data to the uniform
+		gRenderBackend->SetUniformMatrix4(loc, matrix.GetAsFloatPtr());
+	}
 }
 
-void Shader::SetVectorUniform(const char* name, const Vector3& vector) const
+void Shader::SetUniform(const Uniform<Vector2>& uniform, const Vector2& vector)
 {
-	GLint loc = glGetUniformLocation(mShaderProgram, name);
-	// Send the vector data
-	glUniform3fv(loc, 1, vector.GetAsFloatPtr());
+	const float VALUE[2] = {vector.x, vector.y};
+	GLint loc = UpdateUniform(uniform.GetID(), VALUE, sizeof(VALUE));
+	if (loc != -1)
+	{
+		// Send the vector data
+		gRenderBackend->SetUniformFloats(loc, 2, VALUE);
+	}
 }
 
-void Shader::SetVector4Uniform(const char* name, const Vector4& vector) const
+void Shader::SetUniform(const Uniform<Vector3>& uniform, const Vector3& vector)
 {
-	GLint loc = glGetUniformLocation(mShaderProgram, name);
-	// Send the vector data
-	glUniform4fv(loc, 1, vector.GetAsFloatPtr());
+	GLint loc = UpdateUniform(uniform.GetID(), vector.GetAsFloatPtr(), sizeof(float) * 3);
+	if (loc != -1)
+	{
+		// Send the vector data
+		gRenderBackend->SetUniformFloats(loc, 3, vector.GetAsFloatPtr());
+	}
 }
 
-void Shader::SetFloatUniform(const char* name, float value) const
+void Shader::SetUniform(const Uniform<Vector4>& uniform, const Vector4& vector)
 {
-	GLint loc = glGetUniformLocation(mShaderProgram, name);
-	// Send the float data
-	glUniform1f(loc, value);
+	GLint loc = UpdateUniform(uniform.GetID(), vector.GetAsFloatPtr(), sizeof(float) * 4);
+	if (loc != -1)
+	{
+		// Send the vector data
+		gRenderBackend->SetUniformFloats(loc, 4, vector.GetAsFloatPtr());
+	}
 }
 
-void Shader::SetIntUniform(const char* name, int value) const
+void Shader::SetUniform(const Uniform<float>& uniform, float value)
 {
-	GLint loc = glGetUniformLocation(mShaderProgram, name);
-	// Send the float data
-	glUniform1i(loc, value);
+	GLint loc = UpdateUniform(uniform.GetID(), &value, sizeof(value));
+	if (loc != -1)
+	{
+		// Send the float data
+		gRenderBackend->SetUniformFloats(loc, 1, &value);
+	}
 }
 
-bool Shader::CompileShader(const std::string& fileName, GLenum shaderType, GLuint& outShader)
+void Shader::SetUniform(const Uniform<int>& uniform, int value)
 {
-	// Open file
-	std::ifstream shaderFile(fileName);
-	if (shaderFile.is_open())
+	GLint loc = UpdateUniform(uniform.GetID(), &value, sizeof(value));
+	if (loc != -1)
 	{
-		// Read all of the text into a string
-		std::stringstream sstream;
-		sstream << shaderFile.rdbuf();
-		std::string contents = sstream.str();
-		const char* contentsChar = contents.c_str();
-
-		// Create a shader of the specified type
-		outShader = glCreateShader(shaderType);
-		// Set the source characters and try to compile
-		glShaderSource(outShader, 1, &(contentsChar), nullptr);
-		glCompileShader(outShader);
-
-		if (!IsCompiled(outShader))
-		{
-			SDL_Log("Failed to compile shader %s", fileName.c_str());
-			return false;
-		}
+		// Send the int data
+		gRenderBackend->SetUniformInt(loc, value);
 	}
-	else
+}
+
+void Shader::SetDrawIndex(int index)
+{
+	SetUniform(DRAW_INDEX, index);
+}
+
+void Shader::SetMatrixUniform(const char* name, const Matrix4& matrix)
+{
+	SetUniform(Uniform<Matrix4>(name), matrix);
+}
+
+void Shader::SetVector2Uniform(const char* name, const Vector2& vector)
+{
+	SetUniform(Uniform<Vector2>(name), vector);
+}
+
+void Shader::SetVectorUniform(const char* name, const Vector3& vector)
+{
+	SetUniform(Uniform<Vector3>(name), vector);
+}
+
+void Shader::SetVector4Uniform(const char* name, const Vector4& vector)
+{
+	SetUniform(Uniform<Vector4>(name), vector);
+}
+
+void Shader::SetFloatUniform(const char* name, float value)
+{
+	SetUniform(Uniform<float>(name), value);
+}
+
+void Shader::SetIntUniform(const char* name, int value)
+{
+	SetUniform(Uniform<int>(name), value);
+}
+
+int Shader::GetUniformID(const char* name)
+{
+	// Shared by every shader, and only grows
+	static std::unordered_map<std::string, int> ids;
+	auto iter = ids.find(name);
+	if (iter != ids.end())
 	{
-		SDL_Log("Shader file not found: %s", fileName.c_str());
-		return false;
+		return iter->second;
 	}
-
-	return true;
+	int id = static_cast<int>(ids.size());
+	ids.emplace(name, id);
+	return id;
 }
 
-bool Shader::IsCompiled(GLuint shader)
+void Shader::ReflectUniforms()
 {
-	GLint status = 0;
-	// Query the compile status
-	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	mUniforms.clear();
 
-	if (status != GL_TRUE)
+	std::vector<std::pair<std::string, GLint>> uniforms;
+	gRenderBackend->GetActiveUniforms(mShaderProgram, uniforms);
+	for (const auto& [name, loc] : uniforms)
 	{
-		char buffer[512] = {};
-		glGetShaderInfoLog(shader, 511, nullptr, buffer);
-		SDL_Log("GLSL Compile Failed:\n%s", buffer);
-		return false;
+		size_t id = static_cast<size_t>(GetUniformID(name.c_str()));
+		if (id >= mUniforms.size())
+		{
+			mUniforms.resize(id + 1);
+		}
+		mUniforms[id].mLocation = loc;
 	}
 
-	return true;
+	// GLSL 3.30 can't give blocks a binding itself
+	const std::pair<const char*, unsigned int> BLOCKS[] = {{"PassData", PASS_DATA_BINDING},
+															 {"DrawData", DRAW_DATA_BINDING}};
+	for (const auto& [name, binding] : BLOCKS)
+	{
+		gRenderBackend->SetUniformBlockBinding(mShaderProgram, name, binding);
+	}
 }
 
-bool Shader::IsValidProgram() const
+GLint Shader::UpdateUniform(int id, const void* data, size_t size)
 {
+	// Every uniform the program has got its ID when it linked, so
+	// anything past the end isn't in this program
+	if (static_cast<size_t>(id) >= mUniforms.size())
+	{
+		return -1;
+	}
 
-	GLint status = 0;
-	// Query the link status
-	glGetProgramiv(mShaderProgram, GL_LINK_STATUS, &status);
-	if (status != GL_TRUE)
+	UniformSlot& slot = mUniforms[id];
+	if (slot.mLocation == -1 || (slot.mHasValue && std::memcmp(slot.mValue, data, size) == 0))
 	{
-		char buffer[512] = {};
-		glGetProgramInfoLog(mShaderProgram, 511, nullptr, buffer);
-		SDL_Log("GLSL Link Status:\n%s", buffer);
+		return -1;
+	}
+	std::memcpy(slot.mValue, data, size);
+	slot.mHasValue = true;
+	return slot.mLocation;
+}
+
+bool Shader::ReadSource(const std::string& fileName, std::string& outSource)
+{
+	// Open file
+	std::ifstream shaderFile(fileName);
+	if (!shaderFile.is_open())
+	{
+		SDL_Log("Shader file not found: %s", fileName.c_str());
 		return false;
 	}
 
+	// Read all of the text into a string
+	std::stringstream sstream;
+	sstream << shaderFile.rdbuf();
+	outSource = sstream.str();
 	return true;
 }
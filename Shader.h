@@ -1,8 +1,12 @@
 #pragma once
 #include <GL/glew.h>
 #include <string>
+#include <vector>
 #include "Math.h"
 
+template <typename T>
+class Uniform;
+
 class Shader
 {
 public:
@@ -14,27 +18,77 @@ public:
 	void Unload();
 	// Set this as the active shader program
 	void SetActive() const;
+
+	// Set a uniform through a handle (see Uniform below). Skips the upload
+	// when it already has this value. The shader must be active.
+	void SetUniform(const Uniform<Matrix4>& uniform, const Matrix4& matrix);
+	void SetUniform(const Uniform<Vector2>& uniform, const Vector2& vector);
+	void SetUniform(const Uniform<Vector3>& uniform, const Vector3& vector);
+	void SetUniform(const Uniform<Vector4>& uniform, const Vector4& vector);
+	void SetUniform(const Uniform<float>& uniform, float value);
+	void SetUniform(const Uniform<int>& uniform, int value);
+
+	// Same, looking the name up first (for setup, use a handle when drawing)
 	// Sets a Matrix uniform
-	void SetMatrixUniform(const char* name, const Matrix4& matrix) const;
+	void SetMatrixUniform(const char* name, const Matrix4& matrix);
+	// Sets a Vector2 uniform
+	void SetVector2Uniform(const char* name, const Vector2& vector);
 	// Sets a Vector3 uniform
-	void SetVectorUniform(const char* name, const Vector3& vector) const;
-	void SetVector4Uniform(const char* name, const Vector4& vector) const;
+	void SetVectorUniform(const char* name, const Vector3& vector);
+	void SetVector4Uniform(const char* name, const Vector4& vector);
 	// Sets a float uniform
-	void SetFloatUniform(const char* name, float value) const;
+	void SetFloatUniform(const char* name, float value);
 	// Sets an int uniform
-	void SetIntUniform(const char* name, int value) const;
+	void SetIntUniform(const char* name, int value);
+
+	// Every uniform name gets an ID, the same in every shader
+	static int GetUniformID(const char* name);
+
+	// Binding points of the uniform blocks the shaders share (see UniformRing)
+	static constexpr unsigned int PASS_DATA_BINDING = 0;
+	static constexpr unsigned int DRAW_DATA_BINDING = 1;
+	// World transforms in DrawData's array (16 KB, the least GL guarantees)
+	static constexpr size_t DRAW_DATA_COUNT = 256;
+	// Which of them the next draw uses (what UniformRing::Bind returned)
+	void SetDrawIndex(int index);
 
 private:
-	// Tries to compile the specified shader
-	static bool CompileShader(const std::string& fileName, GLenum shaderType, GLuint& outShader);
+	// Reads the source of one of the shaders
+	static bool ReadSource(const std::string& fileName, std::string& outSource);
 
-	// Tests whether shader compiled successfully
-	static bool IsCompiled(GLuint shader);
-	// Tests whether vertex/fragment programs link
-	bool IsValidProgram() const;
+	// Finds the program's active uniforms after it links, and binds its
+	// uniform blocks
+	void ReflectUniforms();
+	// Location to upload data to, or -1 if the program doesn't have this uniform
+	// or it already holds data
+	GLint UpdateUniform(int id, const void* data, size_t size);
 
-	// Store the shader object IDs
-	GLuint mVertexShader;
-	GLuint mFragShader;
 	GLuint mShaderProgram;
+
+	// A uniform the program has, and the last value set on it
+	struct UniformSlot
+	{
+		GLint mLocation = -1;
+		bool mHasValue = false;
+		float mValue[16] = {};
+	};
+	// Indexed by uniform ID
+	std::vector<UniformSlot> mUniforms;
+};
+
+// Handle to a uniform of type T, looked up once and usable with any shader.
+// Keep them around (as file-scope constants) instead of names.
+template <typename T>
+class Uniform
+{
+public:
+	explicit Uniform(const char* name)
+	: mID(Shader::GetUniformID(name))
+	{
+	}
+
+	int GetID() const { return mID; }
+
+private:
+	int mID;
 };
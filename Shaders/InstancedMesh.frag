@@ -0,0 +1,18 @@
+// Request GLSL 3.3
+#version 330
+
+// Inputs from vertex shader
+in vec2 fragTexCoord;
+flat in float fragTextureLayer;
+
+// This corresponds to the output color to the color buffer
+out vec4 outColor;
+
+// Every texture of the mesh, one per layer
+uniform sampler2DArray uTextureArray;
+
+void main()
+{
+	// Sample color from texture
+	outColor = texture(uTextureArray, vec3(fragTexCoord, fragTextureLayer));
+}
@@ -0,0 +1,48 @@
+// Request GLSL 3.3
+#version 330
+
+// View-proj (the world transform is per instance) and clip plane, set once per pass
+layout(std140, row_major) uniform PassData
+{
+	mat4 uViewProj;
+	vec4 uClipPlane;
+};
+
+// Attribute 0 is position, 1 is normal, 2 is tex coords.
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+// Per instance: the rows of the world transform, then the texture layer
+layout(location = 3) in vec4 inWorldRow0;
+layout(location = 4) in vec4 inWorldRow1;
+layout(location = 5) in vec4 inWorldRow2;
+layout(location = 6) in vec4 inWorldRow3;
+layout(location = 7) in float inTextureLayer;
+
+// Any vertex outputs (other than position)
+out vec2 fragTexCoord;
+flat out float fragTextureLayer;
+
+// Clip plane
+out float gl_ClipDistance[1];
+
+void main()
+{
+	// Rows go in as columns, so world * pos is the same as pos * uWorldTransform
+	// in BasicMesh
+	mat4 world = mat4(inWorldRow0, inWorldRow1, inWorldRow2, inWorldRow3);
+	vec4 worldPos = world * vec4(inPosition, 1.0);
+	gl_Position = worldPos * uViewProj;
+
+	fragTexCoord = inTexCoord;
+	fragTextureLayer = inTextureLayer;
+
+	if (dot(inNormal, vec3(0.0f, 0.0f, 1.0f)) > 0.99f)
+	{
+		gl_ClipDistance[0] = 1.0f;
+	}
+	else
+	{
+		gl_ClipDistance[0] = dot(worldPos, uClipPlane);
+	}
+}
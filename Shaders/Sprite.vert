@@ -9,9 +9,15 @@
 // Request GLSL 3.3
 #version 330
 
-// Uniforms for world transform and view-proj
+// View-proj and clip plane, set once per pass (shared by every shader)
+layout(std140, row_major) uniform PassData
+{
+	mat4 uViewProj;
+	vec4 uClipPlane;
+};
+
+// World transform
 uniform mat4 uWorldTransform;
-uniform mat4 uViewProj;
 
 // Attribute 0 is position, 1 is normal, 2 is tex coords.
 layout(location = 0) in vec3 inPosition;
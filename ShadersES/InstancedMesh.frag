@@ -0,0 +1,21 @@
+#version 300 es
+
+// WebGL requires specifying float precision
+precision highp float;
+precision highp sampler2DArray;
+
+// Inputs from vertex shader
+in vec2 fragTexCoord;
+flat in float fragTextureLayer;
+
+// This corresponds to the output color to the color buffer
+out vec4 outColor;
+
+// Every texture of the mesh, one per layer
+uniform sampler2DArray uTextureArray;
+
+void main()
+{
+	// Sample color from texture
+	outColor = texture(uTextureArray, vec3(fragTexCoord, fragTextureLayer));
+}
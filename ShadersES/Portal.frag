@@ -19,11 +19,29 @@ out vec4 outColor;
 // This is used for the texture sampling
 uniform sampler2D uTexture;
 uniform sampler2D uMask;
+// Last frame, for filling in portals deeper than the renderer draws
+uniform sampler2D uRenderTarget;
+uniform int uReuse;
+// Screen rects (min x, min y, max x, max y) in device coordinates: where the
+// portal is now, and where in last frame to take it from
+uniform vec4 uReuseTo;
+uniform vec4 uReuseFrom;
+uniform vec2 uScreenSize;
 
 void main()
 {
 	vec4 texColor = texture(uTexture, fragTexCoord);
 	if (texture(uMask, fragTexCoord).r < 0.05f)
 		discard;
-	outColor = vec4(0.0f, 0.0f, 0.0f, 0.0f);
+	if (uReuse != 0)
+	{
+		vec2 device = gl_FragCoord.xy / uScreenSize * 2.0f - 1.0f;
+		vec2 t = (device - uReuseTo.xy) / max(uReuseTo.zw - uReuseTo.xy, vec2(0.0001f));
+		vec2 source = mix(uReuseFrom.xy, uReuseFrom.zw, t);
+		outColor = vec4(texture(uRenderTarget, source * 0.5f + 0.5f).rgb, 1.0f);
+	}
+	else
+	{
+		outColor = vec4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
 }
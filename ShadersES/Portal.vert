@@ -8,9 +8,20 @@
 // See LICENSE.txt for full details.
 // ----------------------------------------------------------------
 
-// Uniforms for world transform and view-proj
-uniform mat4 uWorldTransform;
-uniform mat4 uViewProj;
+// View-proj and clip plane, set once per pass (shared by every shader)
+layout(std140, row_major) uniform PassData
+{
+	mat4 uViewProj;
+	vec4 uClipPlane;
+};
+
+// World transforms of the draws in this window (Shader::DRAW_DATA_COUNT),
+// and which one this draw uses
+layout(std140, row_major) uniform DrawData
+{
+	mat4 uWorldTransforms[256];
+};
+uniform int uDrawIndex;
 
 // Attribute 0 is position, 1 is normal, 2 is tex coords.
 layout(location = 0) in vec3 inPosition;
@@ -21,15 +32,15 @@ layout(location = 2) in vec2 inTexCoord;
 out vec2 fragTexCoord;
 
 // Clip plane
-uniform vec4 uClipPlane;
 out float gl_ClipDistance[1];
 
 void main()
 {
+	mat4 worldTransform = uWorldTransforms[uDrawIndex];
 	// Convert position to homogeneous coordinates
 	vec4 pos = vec4(inPosition, 1.0);
 	// Transform to position world space, then clip space
-	gl_Position = pos * uWorldTransform * uViewProj;
+	gl_Position = pos * worldTransform * uViewProj;
 
 	// Pass along the texture coordinate to frag shader
 	fragTexCoord = inTexCoord;
@@ -40,6 +51,6 @@ void main()
 	}
 	else
 	{
-		gl_ClipDistance[0] = dot(pos * uWorldTransform, uClipPlane);
+		gl_ClipDistance[0] = dot(pos * worldTransform, uClipPlane);
 	}
 }
@@ -0,0 +1,193 @@
+#pragma once
+
+// Minimal 4-wide float SIMD wrapper. Uses SSE2 or NEON (64-bit ARM) when available and falls
+// back to plain scalar code (e.g. Emscripten without -msimd128).
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Simd
+{
+#if defined(SIMD_SSE2)
+	struct Float4
+	{
+		__m128 mValue;
+	};
+
+	inline Float4 Load(const float* p) { return {_mm_loadu_ps(p)}; }
+	inline void Store(float* p, Float4 a) { _mm_storeu_ps(p, a.mValue); }
+	inline Float4 Set1(float v) { return {_mm_set1_ps(v)}; }
+	inline Float4 Add(Float4 a, Float4 b) { return {_mm_add_ps(a.mValue, b.mValue)}; }
+	inline Float4 Sub(Float4 a, Float4 b) { return {_mm_sub_ps(a.mValue, b.mValue)}; }
+	inline Float4 Mul(Float4 a, Float4 b) { return {_mm_mul_ps(a.mValue, b.mValue)}; }
+	inline Float4 Min(Float4 a, Float4 b) { return {_mm_min_ps(a.mValue, b.mValue)}; }
+	inline Float4 Max(Float4 a, Float4 b) { return {_mm_max_ps(a.mValue, b.mValue)}; }
+	// Bit i is set if a[i] <= b[i]
+	inline int LessEqualMask(Float4 a, Float4 b)
+	{
+		return _mm_movemask_ps(_mm_cmple_ps(a.mValue, b.mValue));
+	}
+
+	// Per-lane comparison results
+	struct Mask4
+	{
+		__m128 mValue;
+	};
+
+	inline Float4 Abs(Float4 a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.mValue)}; }
+	inline Mask4 Less(Float4 a, Float4 b) { return {_mm_cmplt_ps(a.mValue, b.mValue)}; }
+	inline Mask4 LessEqual(Float4 a, Float4 b) { return {_mm_cmple_ps(a.mValue, b.mValue)}; }
+	inline Mask4 And(Mask4 a, Mask4 b) { return {_mm_and_ps(a.mValue, b.mValue)}; }
+	inline int MoveMask(Mask4 m) { return _mm_movemask_ps(m.mValue); }
+	// Lane from a where mask is set, otherwise from b
+	inline Float4 Select(Mask4 m, Float4 a, Float4 b)
+	{
+		return {_mm_or_ps(_mm_and_ps(m.mValue, a.mValue), _mm_andnot_ps(m.mValue, b.mValue))};
+	}
+#elif defined(SIMD_NEON)
+	struct Float4
+	{
+		float32x4_t mValue;
+	};
+
+	inline Float4 Load(const float* p) { return {vld1q_f32(p)}; }
+	inline void Store(float* p, Float4 a) { vst1q_f32(p, a.mValue); }
+	inline Float4 Set1(float v) { return {vdupq_n_f32(v)}; }
+	inline Float4 Add(Float4 a, Float4 b) { return {vaddq_f32(a.mValue, b.mValue)}; }
+	inline Float4 Sub(Float4 a, Float4 b) { return {vsubq_f32(a.mValue, b.mValue)}; }
+	inline Float4 Mul(Float4 a, Float4 b) { return {vmulq_f32(a.mValue, b.mValue)}; }
+	inline Float4 Min(Float4 a, Float4 b) { return {vminq_f32(a.mValue, b.mValue)}; }
+	inline Float4 Max(Float4 a, Float4 b) { return {vmaxq_f32(a.mValue, b.mValue)}; }
+	inline int LessEqualMask(Float4 a, Float4 b)
+	{
+		uint32x4_t cmp = vcleq_f32(a.mValue, b.mValue);
+		uint32x4_t bits = vandq_u32(cmp, uint32x4_t{1, 2, 4, 8});
+		return static_cast<int>(vaddvq_u32(bits));
+	}
+
+	struct Mask4
+	{
+		uint32x4_t mValue;
+	};
+
+	inline Float4 Abs(Float4 a) { return {vabsq_f32(a.mValue)}; }
+	inline Mask4 Less(Float4 a, Float4 b) { return {vcltq_f32(a.mValue, b.mValue)}; }
+	inline Mask4 LessEqual(Float4 a, Float4 b) { return {vcleq_f32(a.mValue, b.mValue)}; }
+	inline Mask4 And(Mask4 a, Mask4 b) { return {vandq_u32(a.mValue, b.mValue)}; }
+	inline int MoveMask(Mask4 m)
+	{
+		uint32x4_t bits = vandq_u32(m.mValue, uint32x4_t{1, 2, 4, 8});
+		return static_cast<int>(vaddvq_u32(bits));
+	}
+	inline Float4 Select(Mask4 m, Float4 a, Float4 b)
+	{
+		return {vbslq_f32(m.mValue, a.mValue, b.mValue)};
+	}
+#else
+	struct Float4
+	{
+		float mValue[4];
+	};
+
+	inline Float4 Load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+	inline void Store(float* p, Float4 a)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			p[i] = a.mValue[i];
+		}
+	}
+	inline Float4 Set1(float v) { return {{v, v, v, v}}; }
+
+	template <typename Op>
+	inline Float4 Apply(Float4 a, Float4 b, Op op)
+	{
+		Float4 retVal;
+		for (int i = 0; i < 4; i++)
+		{
+			retVal.mValue[i] = op(a.mValue[i], b.mValue[i]);
+		}
+		return retVal;
+	}
+
+	inline Float4 Add(Float4 a, Float4 b) { return Apply(a, b, [](float x, float y) { return x + y; }); }
+	inline Float4 Sub(Float4 a, Float4 b) { return Apply(a, b, [](float x, float y) { return x - y; }); }
+	inline Float4 Mul(Float4 a, Float4 b) { return Apply(a, b, [](float x, float y) { return x * y; }); }
+	inline Float4 Min(Float4 a, Float4 b)
+	{
+		return Apply(a, b, [](float x, float y) { return x < y ? x : y; });
+	}
+	inline Float4 Max(Float4 a, Float4 b)
+	{
+		return Apply(a, b, [](float x, float y) { return x > y ? x : y; });
+	}
+	inline int LessEqualMask(Float4 a, Float4 b)
+	{
+		int mask = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			mask |= (a.mValue[i] <= b.mValue[i] ? 1 : 0) << i;
+		}
+		return mask;
+	}
+
+	struct Mask4
+	{
+		bool mValue[4];
+	};
+
+	inline Float4 Abs(Float4 a)
+	{
+		return Apply(a, a, [](float x, float) { return x < 0.0f ? -x : x; });
+	}
+	inline Mask4 Less(Float4 a, Float4 b)
+	{
+		Mask4 m;
+		for (int i = 0; i < 4; i++)
+		{
+			m.mValue[i] = a.mValue[i] < b.mValue[i];
+		}
+		return m;
+	}
+	inline Mask4 LessEqual(Float4 a, Float4 b)
+	{
+		Mask4 m;
+		for (int i = 0; i < 4; i++)
+		{
+			m.mValue[i] = a.mValue[i] <= b.mValue[i];
+		}
+		return m;
+	}
+	inline Mask4 And(Mask4 a, Mask4 b)
+	{
+		Mask4 m;
+		for (int i = 0; i < 4; i++)
+		{
+			m.mValue[i] = a.mValue[i] && b.mValue[i];
+		}
+		return m;
+	}
+	inline int MoveMask(Mask4 m)
+	{
+		int mask = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			mask |= (m.mValue[i] ? 1 : 0) << i;
+		}
+		return mask;
+	}
+	inline Float4 Select(Mask4 m, Float4 a, Float4 b)
+	{
+		Float4 retVal;
+		for (int i = 0; i < 4; i++)
+		{
+			retVal.mValue[i] = m.mValue[i] ? a.mValue[i] : b.mValue[i];
+		}
+		return retVal;
+	}
+#endif
+} // namespace Simd
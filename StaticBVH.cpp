@@ -0,0 +1,132 @@
+#include "StaticBVH.h"
+#include <algorithm>
+
+void StaticBVH::Build(const std::vector<AABB>& boxes)
+{
+	Clear();
+	if (boxes.empty())
+	{
+		return;
+	}
+
+	mBoxes = boxes;
+	mIndices.resize(boxes.size());
+	std::vector<Vector3> centers;
+	centers.reserve(boxes.size());
+	for (size_t i = 0; i < boxes.size(); i++)
+	{
+		mIndices[i] = static_cast<int>(i);
+		centers.emplace_back(boxes[i].GetCenter());
+	}
+
+	// A binary tree with N leaves has at most 2N - 1 nodes
+	mNodes.reserve(boxes.size() * 2);
+	Node& root = mNodes.emplace_back();
+	root.mLeftOrFirst = 0;
+	root.mCount = static_cast<int>(boxes.size());
+	Subdivide(0, boxes, centers);
+}
+
+void StaticBVH::Clear()
+{
+	mNodes.clear();
+	mBoxes.clear();
+	mIndices.clear();
+}
+
+void StaticBVH::Subdivide(int nodeIdx, const std::vector<AABB>& boxes,
+						  const std::vector<Vector3>& centers)
+{
+	// Fit the node around its boxes, and find the spread of their centers
+	const int FIRST = mNodes[nodeIdx].mLeftOrFirst;
+	const int COUNT = mNodes[nodeIdx].mCount;
+	AABB bounds = AABB::Empty();
+	AABB centerBounds = AABB::Empty();
+	for (int i = FIRST; i < FIRST + COUNT; i++)
+	{
+		bounds = AABB::Union(bounds, boxes[mIndices[i]]);
+		centerBounds.AddPoint(centers[mIndices[i]]);
+	}
+	mNodes[nodeIdx].mBox = bounds;
+
+	if (COUNT <= MAX_LEAF_SIZE)
+	{
+		return;
+	}
+
+	// Split at the median center along the widest axis
+	Vector3 extent = centerBounds.mMax - centerBounds.mMin;
+	int axis = 0;
+	if (extent.y > extent.x)
+	{
+		axis = 1;
+	}
+	if (extent.z > (axis == 0 ? extent.x : extent.y))
+	{
+		axis = 2;
+	}
+
+	auto axisValue = [&centers, axis](int idx) {
+		const Vector3& c = centers[idx];
+		return axis == 0 ? c.x : (axis == 1 ? c.y : c.z);
+	};
+
+	const int HALF = COUNT / 2;
+	std::nth_element(mIndices.begin() + FIRST, mIndices.begin() + FIRST + HALF,
+					 mIndices.begin() + FIRST + COUNT, [&axisValue](int a, int b) {
+						 return axisValue(a) < axisValue(b);
+					 });
+
+	// Children are allocated as a pair so the right child is always left + 1
+	const int LEFT = static_cast<int>(mNodes.size());
+	mNodes.emplace_back();
+	mNodes.emplace_back();
+	mNodes[LEFT].mLeftOrFirst = FIRST;
+	mNodes[LEFT].mCount = HALF;
+	mNodes[LEFT + 1].mLeftOrFirst = FIRST + HALF;
+	mNodes[LEFT + 1].mCount = COUNT - HALF;
+
+	mNodes[nodeIdx].mLeftOrFirst = LEFT;
+	mNodes[nodeIdx].mCount = 0;
+
+	Subdivide(LEFT, boxes, centers);
+	Subdivide(LEFT + 1, boxes, centers);
+}
+
+void StaticBVH::Query(const AABB& box, std::vector<int>& outIndices) const
+{
+	if (mNodes.empty())
+	{
+		return;
+	}
+
+	// Explicit stack, the tree is balanced so 64 levels is plenty
+	int stack[64];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = mNodes[stack[--stackSize]];
+		if (!node.mBox.Intersects(box))
+		{
+			continue;
+		}
+
+		if (node.mCount > 0)
+		{
+			for (int i = node.mLeftOrFirst; i < node.mLeftOrFirst + node.mCount; i++)
+			{
+				if (mBoxes[mIndices[i]].Intersects(box))
+				{
+					outIndices.emplace_back(mIndices[i]);
+				}
+			}
+		}
+		else
+		{
+			stack[stackSize++] = node.mLeftOrFirst;
+			stack[stackSize++] = node.mLeftOrFirst + 1;
+		}
+	}
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include "AABB.h"
+#include "AABBRayPacket.h"
+#include <utility>
+#include <vector>
+
+// Bounding volume hierarchy over boxes that never move (blocks, collidable props).
+// Built once after a level is loaded, then only queried.
+class StaticBVH
+{
+public:
+	// Build the tree over boxes. Query results are indices into this vector.
+	void Build(const std::vector<AABB>& boxes);
+	void Clear();
+
+	bool IsEmpty() const { return mNodes.empty(); }
+
+	// Appends the index of every box that overlaps box
+	void Query(const AABB& box, std::vector<int>& outIndices) const;
+
+	// Walks the tree front to back along ray for t in [0, maxT]. For every box the
+	// ray hits, calls hitFunc(index, maxT), which returns the new maxT (e.g. the
+	// closest hit so far). Anything entered past maxT is skipped.
+	template <typename HitFunc>
+	void RayCast(const AABBRay& ray, float maxT, HitFunc&& hitFunc) const
+	{
+		float entryT = 0.0f;
+		if (mNodes.empty() || !mNodes[0].mBox.RayIntersects(ray, maxT, entryT))
+		{
+			return;
+		}
+
+		// Nodes to visit along with their entry t (nearest child on top)
+		std::pair<int, float> stack[64];
+		int stackSize = 0;
+		stack[stackSize++] = {0, entryT};
+
+		while (stackSize > 0)
+		{
+			auto [nodeIdx, nodeT] = stack[--stackSize];
+			// Something closer was found since this was pushed
+			if (nodeT > maxT)
+			{
+				continue;
+			}
+
+			const Node& node = mNodes[nodeIdx];
+			if (node.mCount > 0)
+			{
+				for (int i = node.mLeftOrFirst; i < node.mLeftOrFirst + node.mCount; i++)
+				{
+					if (mBoxes[mIndices[i]].RayIntersects(ray, maxT, entryT))
+					{
+						maxT = hitFunc(mIndices[i], maxT);
+					}
+				}
+				continue;
+			}
+
+			float leftT = 0.0f;
+			float rightT = 0.0f;
+			const int LEFT = node.mLeftOrFirst;
+			bool hitLeft = mNodes[LEFT].mBox.RayIntersects(ray, maxT, leftT);
+			bool hitRight = mNodes[LEFT + 1].mBox.RayIntersects(ray, maxT, rightT);
+			if (hitLeft && hitRight)
+			{
+				// Push the far child first so the near one is visited first
+				if (leftT <= rightT)
+				{
+					stack[stackSize++] = {LEFT + 1, rightT};
+					stack[stackSize++] = {LEFT, leftT};
+				}
+				else
+				{
+					stack[stackSize++] = {LEFT, leftT};
+					stack[stackSize++] = {LEFT + 1, rightT};
+				}
+			}
+			else if (hitLeft)
+			{
+				stack[stackSize++] = {LEFT, leftT};
+			}
+			else if (hitRight)
+			{
+				stack[stackSize++] = {LEFT + 1, rightT};
+			}
+		}
+	}
+
+	// Packet version of RayCast. Visits nodes any lane hits (nearest child along
+	// the packet's average direction first), and calls hitFunc(index, laneMask) for
+	// every box, where laneMask has a bit set per lane that hit it.
+	template <typename HitFunc>
+	void RayCastPacket(const AABBRayPacket& packet, HitFunc&& hitFunc) const
+	{
+		if (mNodes.empty())
+		{
+			return;
+		}
+
+		int stack[64];
+		int stackSize = 0;
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			// Retest on the way out, since lanes may have found closer hits
+			const Node& node = mNodes[stack[--stackSize]];
+			if (packet.Intersect(node.mBox) == 0)
+			{
+				continue;
+			}
+
+			if (node.mCount > 0)
+			{
+				for (int i = node.mLeftOrFirst; i < node.mLeftOrFirst + node.mCount; i++)
+				{
+					unsigned int laneMask = packet.Intersect(mBoxes[mIndices[i]]);
+					if (laneMask != 0)
+					{
+						hitFunc(mIndices[i], laneMask);
+					}
+				}
+				continue;
+			}
+
+			const int LEFT = node.mLeftOrFirst;
+			Vector3 offset = mNodes[LEFT + 1].mBox.GetCenter() - mNodes[LEFT].mBox.GetCenter();
+			if (Vector3::Dot(offset, packet.mAverageDir) >= 0.0f)
+			{
+				stack[stackSize++] = LEFT + 1;
+				stack[stackSize++] = LEFT;
+			}
+			else
+			{
+				stack[stackSize++] = LEFT;
+				stack[stackSize++] = LEFT + 1;
+			}
+		}
+	}
+
+private:
+	struct Node
+	{
+		AABB mBox;
+		// Leaf: first entry in mIndices. Interior: index of the left child
+		// (the right child is always mLeftOrFirst + 1)
+		int mLeftOrFirst = 0;
+		// Number of boxes in a leaf, 0 for interior nodes
+		int mCount = 0;
+	};
+
+	void Subdivide(int nodeIdx, const std::vector<AABB>& boxes,
+				   const std::vector<Vector3>& centers);
+
+	std::vector<Node> mNodes;
+	std::vector<AABB> mBoxes;
+	std::vector<int> mIndices;
+
+	static constexpr int MAX_LEAF_SIZE = 4;
+};
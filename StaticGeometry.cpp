@@ -0,0 +1,173 @@
+#include "StaticGeometry.h"
+#include "Actor.h"
+#include "Frustum.h"
+#include "Mesh.h"
+#include "MeshComponent.h"
+#include "RenderBackend.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "UniformRing.h"
+#include "VertexArray.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+StaticGeometry::~StaticGeometry()
+{
+	Clear();
+}
+
+void StaticGeometry::AddComp(MeshComponent* mc)
+{
+	mComps.emplace_back(mc);
+	mIsDirty = true;
+}
+
+void StaticGeometry::RemoveComp(const MeshComponent* mc)
+{
+	auto iter = std::ranges::find(mComps, mc);
+	if (iter != mComps.end())
+	{
+		mComps.erase(iter);
+		mIsDirty = true;
+	}
+}
+
+void StaticGeometry::Clear()
+{
+	for (Chunk& chunk : mChunks)
+	{
+		delete chunk.mVertexArray;
+	}
+	mChunks.clear();
+}
+
+void StaticGeometry::Build()
+{
+	if (!mIsDirty)
+	{
+		return;
+	}
+	mIsDirty = false;
+	Clear();
+
+	// Sort into chunks by where each one's bounds are centered, then by texture
+	// within a chunk so each texture is one index range
+	using ChunkCoord = std::tuple<int, int, int>;
+	std::map<ChunkCoord, std::vector<MeshComponent*>> chunkComps;
+	for (MeshComponent* mc : mComps)
+	{
+		mc->UpdateWorldBounds();
+		if (!mc->HasWorldBounds())
+		{
+			continue;
+		}
+		const Vector3& center = mc->GetWorldCenter();
+		ChunkCoord coord(static_cast<int>(std::floor(center.x / CHUNK_SIZE)),
+						 static_cast<int>(std::floor(center.y / CHUNK_SIZE)),
+						 static_cast<int>(std::floor(center.z / CHUNK_SIZE)));
+		chunkComps[coord].emplace_back(mc);
+	}
+
+	std::vector<float> vertices;
+	std::vector<unsigned int> indices;
+	for (auto& [coord, comps] : chunkComps)
+	{
+		std::ranges::stable_sort(comps, std::less<>(),
+								 [](const MeshComponent* mc) { return mc->GetTexture(); });
+
+		Chunk& chunk = mChunks.emplace_back();
+		chunk.mBox = comps[0]->GetWorldBox();
+		vertices.clear();
+		indices.clear();
+		for (const MeshComponent* mc : comps)
+		{
+			chunk.mBox.AddPoint(mc->GetWorldBox().mMin);
+			chunk.mBox.AddPoint(mc->GetWorldBox().mMax);
+
+			Texture* texture = mc->GetTexture();
+			if (chunk.mRanges.empty() || chunk.mRanges.back().mTexture != texture)
+			{
+				chunk.mRanges.emplace_back(texture, static_cast<unsigned int>(indices.size()), 0);
+			}
+
+			// Normals go through the inverse transpose, so non-uniform scale is fine
+			const Matrix4& world = mc->GetOwner()->GetTransform().GetWorldTransform();
+			Matrix4 normalMatrix = world;
+			normalMatrix.Invert();
+			normalMatrix.Transpose();
+
+			const Mesh* mesh = mc->GetMesh();
+			const std::vector<float>& meshVerts = mesh->GetVertices();
+			const unsigned int FIRST_VERTEX = static_cast<unsigned int>(vertices.size() / 8);
+			for (size_t i = 0; i + 8 <= meshVerts.size(); i += 8)
+			{
+				Vector3 pos = Vector3::Transform(
+					Vector3(meshVerts[i], meshVerts[i + 1], meshVerts[i + 2]), world);
+				Vector3 normal = Vector3::Transform(
+					Vector3(meshVerts[i + 3], meshVerts[i + 4], meshVerts[i + 5]), normalMatrix,
+					0.0f);
+				normal.Normalize();
+				vertices.insert(vertices.end(), {pos.x, pos.y, pos.z, normal.x, normal.y, normal.z,
+												 meshVerts[i + 6], meshVerts[i + 7]});
+			}
+
+			// A mirroring transform flips the winding, so flip it back
+			Vector3 xAxis = world.GetXAxis();
+			Vector3 yAxis = world.GetYAxis();
+			Vector3 zAxis = world.GetZAxis();
+			const bool MIRRORED = Vector3::Dot(Vector3::Cross(xAxis, yAxis), zAxis) < 0.0f;
+			const std::vector<unsigned int>& meshIndices = mesh->GetIndices();
+			for (size_t i = 0; i + 3 <= meshIndices.size(); i += 3)
+			{
+				indices.emplace_back(FIRST_VERTEX + meshIndices[i]);
+				indices.emplace_back(FIRST_VERTEX + meshIndices[MIRRORED ? i + 2 : i + 1]);
+				indices.emplace_back(FIRST_VERTEX + meshIndices[MIRRORED ? i + 1 : i + 2]);
+			}
+			chunk.mRanges.back().mNumIndices += static_cast<unsigned int>(meshIndices.size());
+		}
+
+		chunk.mVertexArray = new VertexArray(vertices.data(),
+											 static_cast<unsigned int>(vertices.size() / 8),
+											 indices.data(),
+											 static_cast<unsigned int>(indices.size()));
+	}
+}
+
+void StaticGeometry::AddDrawData(UniformRing& drawData)
+{
+	// Already in world space
+	mDrawData = drawData.Add(&Matrix4::Identity);
+}
+
+void StaticGeometry::Draw(Shader* shader, const UniformRing& drawData, const Frustum& frustum,
+						  CullStats& stats) const
+{
+	if (mChunks.empty())
+	{
+		return;
+	}
+
+	shader->SetDrawIndex(drawData.Bind(mDrawData));
+	for (const Chunk& chunk : mChunks)
+	{
+		stats.mTested++;
+		if (!frustum.IntersectsBox(chunk.mBox))
+		{
+			stats.mCulled++;
+			continue;
+		}
+
+		chunk.mVertexArray->SetActive();
+		for (const TextureRange& range : chunk.mRanges)
+		{
+			if (range.mTexture)
+			{
+				range.mTexture->SetActive();
+			}
+			gRenderBackend->DrawIndexed(range.mFirstIndex, range.mNumIndices);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "AABB.h"
+#include <vector>
+
+struct Frustum;
+struct CullStats;
+class MeshComponent;
+
+// Level geometry that never moves, baked into world-space vertex arrays: one
+// per CHUNK_SIZE cube of the level, each drawn with one call per texture. So
+// drawing it costs per visible chunk, not per object, and needs no world
+// transforms.
+class StaticGeometry
+{
+public:
+	~StaticGeometry();
+
+	// Changes take effect at the next Build
+	void AddComp(MeshComponent* mc);
+	void RemoveComp(const MeshComponent* mc);
+
+	// Rebuilds the chunks if components were added or removed since last time
+	void Build();
+	// Deletes the chunks (the components are kept)
+	void Clear();
+
+	// Stages the draw data for a pass (an identity world transform)
+	void AddDrawData(class UniformRing& drawData);
+	// Draws the chunks inside frustum with the active shader (which has the
+	// pass's view-projection). Stats count chunks.
+	void Draw(class Shader* shader, const class UniformRing& drawData, const Frustum& frustum,
+			  CullStats& stats) const;
+
+	size_t GetNumChunks() const { return mChunks.size(); }
+
+private:
+	// Everything in a chunk using one texture
+	struct TextureRange
+	{
+		class Texture* mTexture = nullptr;
+		unsigned int mFirstIndex = 0;
+		unsigned int mNumIndices = 0;
+	};
+
+	struct Chunk
+	{
+		AABB mBox;
+		class VertexArray* mVertexArray = nullptr;
+		std::vector<TextureRange> mRanges;
+	};
+
+	static constexpr float CHUNK_SIZE = 1024.0f;
+
+	std::vector<Chunk> mChunks;
+	std::vector<MeshComponent*> mComps;
+	bool mIsDirty = false;
+	int mDrawData = 0;
+};
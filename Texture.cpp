@@ -1,6 +1,8 @@
 #include "Texture.h"
-#include <GL/glew.h>
+#include "GLState.h"
+#include "RenderBackend.h"
 #include <SDL3/SDL.h>
+#include <algorithm>
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_ONLY_PNG
 #include <stb/stb_image.h>
@@ -30,31 +32,97 @@ bool Texture::Load(const std::string& fileName)
 		format = GL_RGBA;
 	}
 
-	glGenTextures(1, &mTextureID);
-	glBindTexture(GL_TEXTURE_2D, mTextureID);
-	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-	glTexImage2D(GL_TEXTURE_2D, 0, format, mWidth, mHeight, 0, format, GL_UNSIGNED_BYTE, image);
+	mTextureID = gRenderBackend->CreateTexture();
+	gGLState.BindTexture(0, GL_TEXTURE_2D, mTextureID);
+	gRenderBackend->TexImage2D(GL_TEXTURE_2D, format, mWidth, mHeight, format, image);
 
 	stbi_image_free(image);
 
 	// Generate mipmaps for texture
-	glGenerateMipmap(GL_TEXTURE_2D);
+	gRenderBackend->GenerateMipmap(GL_TEXTURE_2D);
 	// Enable linear filtering
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	gRenderBackend->SetTextureFilter(GL_TEXTURE_2D, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
 
 	return true;
 }
 
 void Texture::Unload() const
 {
-	glDeleteTextures(1, &mTextureID);
+	gRenderBackend->DeleteTexture(mTextureID);
+	gGLState.OnTextureDeleted(mTextureID);
+}
+
+bool Texture::LoadArray(const std::vector<std::string>& fileNames)
+{
+	// Layers all have to be the same size, so everything is made as big as the
+	// largest image
+	std::vector<unsigned char*> images;
+	std::vector<std::pair<int, int>> sizes;
+	mWidth = 0;
+	mHeight = 0;
+	for (const std::string& fileName : fileNames)
+	{
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		unsigned char* image = stbi_load(fileName.c_str(), &width, &height, &channels, 4);
+		if (image == nullptr)
+		{
+			SDL_Log("SOIL failed to load image %s: %s", fileName.c_str(), stbi_failure_reason());
+			for (unsigned char* loaded : images)
+			{
+				stbi_image_free(loaded);
+			}
+			return false;
+		}
+		images.emplace_back(image);
+		sizes.emplace_back(width, height);
+		mWidth = std::max(mWidth, width);
+		mHeight = std::max(mHeight, height);
+	}
+	mNumLayers = static_cast<int>(images.size());
+
+	mTextureID = gRenderBackend->CreateTexture();
+	gGLState.BindTexture(0, GL_TEXTURE_2D_ARRAY, mTextureID);
+	gRenderBackend->TexImage3D(GL_TEXTURE_2D_ARRAY, GL_RGBA8, mWidth, mHeight, mNumLayers,
+							   GL_RGBA);
+
+	std::vector<unsigned char> scaled;
+	for (int layer = 0; layer < mNumLayers; layer++)
+	{
+		const unsigned char* pixels = images[layer];
+		auto [width, height] = sizes[layer];
+		if (width != mWidth || height != mHeight)
+		{
+			// Nearest neighbor (the sizes are powers of two, so it's just repeating pixels)
+			scaled.resize(static_cast<size_t>(mWidth) * mHeight * 4);
+			for (int y = 0; y < mHeight; y++)
+			{
+				const unsigned char* srcRow = pixels + static_cast<size_t>(y * height / mHeight) *
+														   width * 4;
+				for (int x = 0; x < mWidth; x++)
+				{
+					std::copy_n(srcRow + static_cast<size_t>(x * width / mWidth) * 4, 4,
+								&scaled[(static_cast<size_t>(y) * mWidth + x) * 4]);
+				}
+			}
+			pixels = scaled.data();
+		}
+		gRenderBackend->TexSubImage3D(GL_TEXTURE_2D_ARRAY, layer, mWidth, mHeight, GL_RGBA,
+									  pixels);
+		stbi_image_free(images[layer]);
+	}
+
+	gRenderBackend->GenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	gRenderBackend->SetTextureFilter(GL_TEXTURE_2D_ARRAY, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+
+	return true;
 }
 
 void Texture::SetActive(int index) const
 {
-	glActiveTexture(GL_TEXTURE0 + index);
-	glBindTexture(GL_TEXTURE_2D, mTextureID);
+	gGLState.BindTexture(static_cast<unsigned int>(index),
+						 mNumLayers > 0 ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, mTextureID);
 }
 
 void Texture::CreateFromSurface(const SDL_Surface* surface)
@@ -63,15 +131,13 @@ void Texture::CreateFromSurface(const SDL_Surface* surface)
 	mHeight = surface->h;
 
 	// Generate a GL texture
-	glGenTextures(1, &mTextureID);
-	glBindTexture(GL_TEXTURE_2D, mTextureID);
-	glPixelStorei(GL_UNPACK_ROW_LENGTH, surface->pitch / 4);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-				 surface->pixels);
+	mTextureID = gRenderBackend->CreateTexture();
+	gGLState.BindTexture(0, GL_TEXTURE_2D, mTextureID);
+	gRenderBackend->TexImage2D(GL_TEXTURE_2D, GL_RGBA, mWidth, mHeight, GL_RGBA, surface->pixels,
+							   surface->pitch / 4);
 
 	// Use linear filtering
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	gRenderBackend->SetTextureFilter(GL_TEXTURE_2D, GL_LINEAR, GL_LINEAR);
 }
 
 void Texture::CreateForRendering(int width, int height, unsigned int format)
@@ -79,13 +145,12 @@ void Texture::CreateForRendering(int width, int height, unsigned int format)
 	mWidth = width;
 	mHeight = height;
 	// Create the texture id
-	glGenTextures(1, &mTextureID);
-	glBindTexture(GL_TEXTURE_2D, mTextureID);
+	mTextureID = gRenderBackend->CreateTexture();
+	gGLState.BindTexture(0, GL_TEXTURE_2D, mTextureID);
 	// Set the image width/height with null initial data
-	glTexImage2D(GL_TEXTURE_2D, 0, static_cast<int>(format), mWidth, mHeight, 0, GL_RGBA,
-				 GL_UNSIGNED_BYTE, nullptr);
+	gRenderBackend->TexImage2D(GL_TEXTURE_2D, static_cast<int>(format), mWidth, mHeight, GL_RGBA,
+							   nullptr);
 
 	// For a texture we'll render to, just use nearest neighbor
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	gRenderBackend->SetTextureFilter(GL_TEXTURE_2D, GL_NEAREST, GL_NEAREST);
 }
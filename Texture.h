@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <SDL3/SDL_surface.h>
 
 class Texture
@@ -8,6 +9,8 @@ public:
 	Texture();
 
 	bool Load(const std::string& fileName);
+	// One GL_TEXTURE_2D_ARRAY layer per file, in order
+	bool LoadArray(const std::vector<std::string>& fileNames);
 	void Unload() const;
 	void CreateFromSurface(const SDL_Surface* surface);
 	void CreateForRendering(int width, int height, unsigned int format);
@@ -16,6 +19,7 @@ public:
 
 	int GetWidth() const { return mWidth; }
 	int GetHeight() const { return mHeight; }
+	int GetNumLayers() const { return mNumLayers; }
 
 	unsigned int GetTextureID() const { return mTextureID; }
 
@@ -23,4 +27,6 @@ private:
 	unsigned int mTextureID;
 	int mWidth;
 	int mHeight;
+	// 0 unless it's an array
+	int mNumLayers = 0;
 };
@@ -94,6 +94,7 @@ const Matrix4& Transform::GetWorldTransform()
 void Transform::DirtyTransform()
 {
 	mIsTransformDirty = true;
+	mVersion++;
 
 	for (class Actor* child : mChildren)
 	{
@@ -34,6 +34,9 @@ public:
 	// World Transform
 	const Matrix4& GetWorldTransform();
 
+	// Bumped whenever this (or a parent's) transform changes
+	unsigned int GetVersion() const { return mVersion; }
+
 	// Parenting
 	void DirtyTransform();
 	void SetupParent(class Actor* self, class Actor* parent);
@@ -46,6 +49,7 @@ private:
 	// World Transform Variables
 	Matrix4 mWorldTransform;		// World transform matrix
 	bool mIsTransformDirty = false; // Tracks if transform needs recalculating
+	unsigned int mVersion = 0;		// Incremented by DirtyTransform
 
 	Quaternion mQuat;
 
@@ -7,6 +7,7 @@
 #include "TurretHead.h"
 #include "LaserComponent.h"
 #include "HealthComponent.h"
+#include "RigidBodyComponent.h"
 
 TurretBase::TurretBase()
 {
@@ -20,6 +21,7 @@ TurretBase::TurretBase()
 	// Collider for the base
 	mColl = CreateComponent<CollisionComponent>();
 	mColl->SetSize(Vector3(25.0f, 25.0f, 110.0f));
+	mColl->SetLayer(CollisionLayer::Turret);
 
 	// Health component so turrets can be targeted
 	mHealth = CreateComponent<HealthComponent>();
@@ -40,6 +42,10 @@ TurretBase::TurretBase()
 	// Add this base to the collider vector
 	gGame.AddCollider(this);
 
+	// Body for falling once teleported (with a terminal velocity)
+	mBody = CreateComponent<RigidBodyComponent>();
+	mBody->SetMaxSpeed(800.0f);
+
 	// Create the turret head as a child
 	mHead = CreateChild<TurretHead>();
 
@@ -48,6 +54,11 @@ TurretBase::TurretBase()
 	{
 		mHead->GetLaserComponent()->SetIgnoreActor(this);
 	}
+
+	if (mHead)
+	{
+		mHead->AttachBody(mBody);
+	}
 }
 
 TurretBase::~TurretBase()
@@ -6,6 +6,7 @@ class MeshComponent;
 class CollisionComponent;
 class TurretHead;
 class HealthComponent;
+class RigidBodyComponent;
 
 class TurretBase : public Actor
 {
@@ -21,6 +22,7 @@ private:
 	MeshComponent* mMesh = nullptr;
 	CollisionComponent* mColl = nullptr;
 	HealthComponent* mHealth = nullptr;
+	RigidBodyComponent* mBody = nullptr;
 
 	// Child turret head (spinning part that owns the laser)
 	TurretHead* mHead = nullptr;
@@ -5,8 +5,9 @@
 #include "Math.h"
 #include "LaserComponent.h"
 #include "HealthComponent.h"
-#include "Portal.h"
 #include "CollisionComponent.h"
+#include "CollisionWorld.h"
+#include "RigidBodyComponent.h"
 #include "TurretBase.h"
 #include "Random.h" // For Random::GetFloatRange
 #include "AudioSystem.h"
@@ -40,6 +41,18 @@ TurretHead::TurretHead()
 	mSearchGoingOut = true;
 	mHasSearchTarget = false;
 
+	// If a turret teleports, it can't teleport again until 0.25 seconds elapse.
+	// It comes out at the opposite portal, pushed out along its forward.
+	mPortalPolicy.mCooldown = 0.25f;
+	mPortalPolicy.mOnTeleport = [this](const PortalTransfer& transfer) {
+		GetTransform().GetParent()->GetTransform().SetPosition(transfer.mExitPosition);
+		if (mBody)
+		{
+			mBody->AddVelocity(transfer.mExitForward * 250.0f);
+			mBody->Wake();
+		}
+	};
+
 	// Initialize state sounds map
 	mStateSounds[TurretState::Idle] = "TurretIdle.ogg";
 	mStateSounds[TurretState::Search] = "TurretSearch.ogg";
@@ -57,10 +70,10 @@ TurretHead::~TurretHead() = default;
 // State update stubs
 // (Idle/Priming/Firing/Falling/Dead will be filled later)
 // ------------------------
-void TurretHead::UpdateIdle(float /*deltaTime*/)
+void TurretHead::UpdateIdle(float deltaTime)
 {
 	// Check for portal teleport first
-	if (CheckPortalTeleport())
+	if (CheckPortalTeleport(deltaTime))
 	{
 		ChangeState(TurretState::Falling);
 		return;
@@ -76,7 +89,7 @@ void TurretHead::UpdateIdle(float /*deltaTime*/)
 void TurretHead::UpdateSearch(float deltaTime)
 {
 	// Check for portal teleport first
-	if (CheckPortalTeleport())
+	if (CheckPortalTeleport(deltaTime))
 	{
 		ChangeState(TurretState::Falling);
 		return;
@@ -194,10 +207,10 @@ void TurretHead::UpdateSearch(float deltaTime)
 	// come back to Search, this motion can resume from wherever it was.
 }
 
-void TurretHead::UpdatePriming(float /*deltaTime*/)
+void TurretHead::UpdatePriming(float deltaTime)
 {
 	// Check for portal teleport first
-	if (CheckPortalTeleport())
+	if (CheckPortalTeleport(deltaTime))
 	{
 		ChangeState(TurretState::Falling);
 		return;
@@ -225,7 +238,7 @@ void TurretHead::UpdatePriming(float /*deltaTime*/)
 void TurretHead::UpdateFiring(float deltaTime)
 {
 	// Check for portal teleport first
-	if (CheckPortalTeleport())
+	if (CheckPortalTeleport(deltaTime))
 	{
 		ChangeState(TurretState::Falling);
 		return;
@@ -280,96 +293,20 @@ void TurretHead::UpdateFiring(float deltaTime)
 
 void TurretHead::UpdateFalling(float deltaTime)
 {
-	// Get the parent (TurretBase)
-	Actor* parent = GetTransform().GetParent();
-	if (!parent)
+	// The base's rigid body falls (and goes through portals) on its own, unless
+	// it came to rest without landing
+	if (mBody && mBody->IsAwake())
 	{
 		return;
 	}
 
-	// 1. Update the parent's position according to the fall velocity and delta time
-	Vector3 parentPos = parent->GetTransform().GetPosition();
-	parentPos += mFallVelocity * deltaTime;
-	parent->GetTransform().SetPosition(parentPos);
-
-	// 2. Check for a portal teleport (using the helper function). If you don't teleport:
-	if (!CheckPortalTeleport())
-	{
-		// 2a. Update velocity according to a gravity of <0, 0, -980> and delta time
-		constexpr Vector3 GRAVITY(0.0f, 0.0f, -980.0f);
-		mFallVelocity += GRAVITY * deltaTime;
-
-		// 2b. Use GetMinOverlap between the parent's collision and all colliders
-		// (keep in mind that the parent is also a collider, and you don't want to collide against that)
-		CollisionComponent* parentColl = parent->GetComponent<CollisionComponent>();
-		if (parentColl)
-		{
-			for (Actor* collider : gGame.GetColliders())
-			{
-				// Skip the parent itself
-				if (collider == parent)
-				{
-					continue;
-				}
-
-				CollisionComponent* otherColl = collider->GetComponent<CollisionComponent>();
-				if (!otherColl)
-				{
-					continue;
-				}
-
-				Vector3 offset;
-				CollSide side = parentColl->GetMinOverlap(otherColl, offset);
-				if (side != CollSide::None)
-				{
-					// Update position based on offset
-					Vector3 currentPos = parent->GetTransform().GetPosition();
-					currentPos += offset;
-					parent->GetTransform().SetPosition(currentPos);
-
-					// If, while falling (after applying the offset), the turret has a CollSide::Top collision
-					// AND a negative z velocity (meaning it's falling down), then:
-					if (side == CollSide::Top && mFallVelocity.z < 0.0f)
-					{
-						// Subtract 15 from the parent's z-position (this will make it appear more on the ground)
-						currentPos = parent->GetTransform().GetPosition();
-						currentPos.z -= 15.0f;
-						parent->GetTransform().SetPosition(currentPos);
-
-						// Call Die()
-						Die();
-
-						// Furthermore, if the CollSide::Top collision was against another TurretBase:
-						TurretBase* otherTurret = dynamic_cast<TurretBase*>(collider);
-						if (otherTurret)
-						{
-							// Adjust the parent's position further by subtracting 55 from the z-coordinate
-							currentPos = parent->GetTransform().GetPosition();
-							currentPos.z -= 55.0f;
-							parent->GetTransform().SetPosition(currentPos);
-
-							// Call Die on the other TurretBase
-							otherTurret->Die();
-						}
-					}
-				}
-			}
-		}
-	}
-
-	// 3. If the length of the fall velocity is greater than 800.0f, normalize it and multiply by 800.0f (for a terminal velocity)
-	float velocityLength = mFallVelocity.Length();
-	if (velocityLength > 800.0f)
-	{
-		mFallVelocity.Normalize();
-		mFallVelocity *= 800.0f;
-	}
+	CheckPortalTeleport(deltaTime);
 }
 
-void TurretHead::UpdateDead(float /*deltaTime*/)
+void TurretHead::UpdateDead(float deltaTime)
 {
 	// Check for portal teleport first
-	if (CheckPortalTeleport())
+	if (CheckPortalTeleport(deltaTime))
 	{
 		ChangeState(TurretState::Falling);
 		return;
@@ -421,16 +358,6 @@ void TurretHead::HandleUpdate(float deltaTime)
 	// Update the timer first
 	mStateTimer += deltaTime;
 
-	// Update portal teleport cooldown
-	if (mPortalTeleportCooldown > 0.0f)
-	{
-		mPortalTeleportCooldown -= deltaTime;
-		if (mPortalTeleportCooldown < 0.0f)
-		{
-			mPortalTeleportCooldown = 0.0f;
-		}
-	}
-
 	// State machine
 	switch (mState)
 	{
@@ -491,22 +418,8 @@ bool TurretHead::CheckTargetAcquisition()
 // ------------------------
 // Portal teleporting
 // ------------------------
-bool TurretHead::CheckPortalTeleport()
+bool TurretHead::CheckPortalTeleport(float deltaTime)
 {
-	// If a turret teleports, it can't teleport again until 0.25 seconds elapse
-	if (mPortalTeleportCooldown > 0.0f)
-	{
-		return false;
-	}
-
-	// You can't teleport unless there is both a blue and orange portal
-	Portal* bluePortal = gGame.GetBluePortal();
-	Portal* orangePortal = gGame.GetOrangePortal();
-	if (!bluePortal || !orangePortal)
-	{
-		return false;
-	}
-
 	// To check for intersection with a portal, get the parent (TurretBase) and its CollisionComponent
 	Actor* parent = GetTransform().GetParent();
 	if (!parent)
@@ -514,47 +427,51 @@ bool TurretHead::CheckPortalTeleport()
 		return false;
 	}
 
+	// Every state checks once per frame, so this also ticks the cooldown
 	CollisionComponent* parentColl = parent->GetComponent<CollisionComponent>();
-	if (!parentColl)
-	{
-		return false;
-	}
-
-	Portal* entryPortal = nullptr;
-	Portal* exitPortal = nullptr;
+	return gGame.GetPortalSystem()->TryTeleport(parentColl, mPortalPolicy, deltaTime);
+}
 
-	// Check intersection with blue portal
-	if (CollisionComponent* blueColl = bluePortal->GetComponent<CollisionComponent>();
-		blueColl && parentColl->Intersect(blueColl))
-	{
-		entryPortal = bluePortal;
-		exitPortal = orangePortal;
-	}
-	// Check intersection with orange portal
-	else if (CollisionComponent* orangeColl = orangePortal->GetComponent<CollisionComponent>();
-			 orangeColl && parentColl->Intersect(orangeColl))
-	{
-		entryPortal = orangePortal;
-		exitPortal = bluePortal;
-	}
+void TurretHead::AttachBody(RigidBodyComponent* body)
+{
+	mBody = body;
+	mBody->SetPortalPolicy(&mPortalPolicy);
+	mBody->SetOnContact([this](const Contact& contact) {
+		OnBodyContact(contact);
+	});
+}
 
-	if (!entryPortal || !exitPortal)
+void TurretHead::OnBodyContact(const Contact& contact)
+{
+	// If, while falling, the turret has a CollSide::Top collision AND a negative
+	// z velocity (meaning it's falling down), it landed
+	if (mState != TurretState::Falling || contact.mSide != CollSide::Top ||
+		mBody->GetVelocity().z >= 0.0f)
 	{
-		return false;
+		return;
 	}
 
-	// Set the parent's position to the position of the opposite portal
-	Vector3 exitPos = exitPortal->GetTransform().GetPosition();
-	parent->GetTransform().SetPosition(exitPos);
+	// Subtract 15 from the parent's z-position (this will make it appear more on the ground)
+	Transform& parentXform = GetTransform().GetParent()->GetTransform();
+	Vector3 currentPos = parentXform.GetPosition();
+	currentPos.z -= 15.0f;
+	parentXform.SetPosition(currentPos);
 
-	// Add to the fall velocity a vector in the direction of the portal's forward with a magnitude of 250
-	Vector3 exitForward = exitPortal->GetTransform().GetForward();
-	mFallVelocity += exitForward * 250.0f;
+	// Call Die() (which also stops the body)
+	Die();
 
-	// Start cooldown
-	mPortalTeleportCooldown = 0.25f;
+	// Furthermore, if the CollSide::Top collision was against another TurretBase:
+	if (contact.mOther->GetLayer() == CollisionLayer::Turret)
+	{
+		auto* otherTurret = static_cast<TurretBase*>(contact.mOther->GetOwner());
+		// Adjust the parent's position further by subtracting 55 from the z-coordinate
+		currentPos = parentXform.GetPosition();
+		currentPos.z -= 55.0f;
+		parentXform.SetPosition(currentPos);
 
-	return true;
+		// Call Die on the other TurretBase
+		otherTurret->Die();
+	}
 }
 
 // ------------------------
@@ -573,6 +490,12 @@ void TurretHead::Die()
 		parent->GetTransform().SetQuat(rotX);
 	}
 
+	// Dead turrets stay where they are until they're teleported
+	if (mBody)
+	{
+		mBody->Sleep();
+	}
+
 	// Disable the laser component
 	if (mLaserComp)
 	{
@@ -3,11 +3,15 @@
 #include "Actor.h"
 #include "Math.h" // For Quaternion, Vector3, etc.
 #include "AudioSystem.h"
+#include "PortalSystem.h"
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 class LaserComponent;
 class HealthComponent;
+class RigidBodyComponent;
+struct Contact;
 
 // ----------------------
 // Turret states
@@ -28,6 +32,8 @@ public:
 	LaserComponent* GetLaserComponent() const { return mLaserComp; }
 	void Die();
 	void TakeDamage();
+	// Called by the base with its body, which does the falling
+	void AttachBody(RigidBodyComponent* body);
 
 protected:
 	TurretHead();
@@ -51,9 +57,12 @@ private:
 	class Actor* mAcquiredTarget = nullptr;
 
 	// --- Portal teleporting ---
-	Vector3 mFallVelocity = Vector3::Zero;
-	float mPortalTeleportCooldown = 0.0f;
-	bool CheckPortalTeleport();
+	PortalPolicy mPortalPolicy;
+	bool CheckPortalTeleport(float deltaTime);
+
+	// --- Falling ---
+	RigidBodyComponent* mBody = nullptr;
+	void OnBodyContact(const Contact& contact);
 
 	// --- Search motion members ---
 	// Interpolation from mSearchStartQuat -> mSearchEndQuat over 0.5 seconds
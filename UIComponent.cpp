@@ -3,6 +3,12 @@
 #include "Shader.h"
 #include "Game.h"
 #include "Renderer.h"
+#include "RenderBackend.h"
+
+namespace
+{
+	const Uniform<Matrix4> WORLD_TRANSFORM("uWorldTransform");
+} // namespace
 
 UIComponent::UIComponent(Actor* owner)
 : Component(owner)
@@ -19,7 +25,7 @@ void UIComponent::Draw(Shader* shader)
 {
 }
 
-void UIComponent::DrawTexture(const Shader* shader, const Texture* texture, const Vector2& offset,
+void UIComponent::DrawTexture(Shader* shader, const Texture* texture, const Vector2& offset,
 							  float scale, float angle)
 {
 	// Scale the quad by the width/height of texture
@@ -30,9 +36,9 @@ void UIComponent::DrawTexture(const Shader* shader, const Texture* texture, cons
 	Matrix4 transMat = Matrix4::CreateTranslation(Vector3(offset.x, offset.y, 0.0f));
 	// Set world transform
 	Matrix4 world = scaleMat * rotMat * transMat;
-	shader->SetMatrixUniform("uWorldTransform", world);
+	shader->SetUniform(WORLD_TRANSFORM, world);
 	// Set current texture
 	texture->SetActive();
 	// Draw quad
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+	gRenderBackend->DrawIndexed(0, 6);
 }
@@ -15,7 +15,7 @@ public:
 
 protected:
 	// Helper to draw a texture
-	static void DrawTexture(const class Shader* shader, const class Texture* texture,
+	static void DrawTexture(class Shader* shader, const class Texture* texture,
 							const Vector2& offset = Vector2::Zero, float scale = 1.0f,
 							float angle = 0.0f);
 };
@@ -0,0 +1,86 @@
+#include "UniformRing.h"
+#include "RenderBackend.h"
+#include <algorithm>
+#include <cstring>
+
+UniformRing::UniformRing(unsigned int binding, size_t blockSize, size_t blocksPerBind)
+: mBinding(binding)
+, mBlockSize(blockSize)
+, mBlocksPerBind(blocksPerBind)
+{
+	mAlignment = gRenderBackend->GetUniformBufferAlignment();
+	if (mBlocksPerBind == 1)
+	{
+		mStride = (mBlockSize + mAlignment - 1) / mAlignment * mAlignment;
+	}
+	else
+	{
+		// Packed like the array in the shader
+		mStride = mBlockSize;
+	}
+	mBindSize = mBlocksPerBind * mBlockSize;
+
+	mBuffer = gRenderBackend->CreateBuffer();
+	gRenderBackend->BindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+	gRenderBackend->BufferData(GL_UNIFORM_BUFFER, mCapacity, nullptr, GL_STREAM_DRAW);
+}
+
+UniformRing::~UniformRing()
+{
+	gRenderBackend->DeleteBuffer(mBuffer);
+}
+
+int UniformRing::Add(const void* data)
+{
+	const size_t OFFSET = mStaging.size();
+	mStaging.resize(OFFSET + mStride);
+	std::memcpy(mStaging.data() + OFFSET, data, mBlockSize);
+	return static_cast<int>(OFFSET / mStride);
+}
+
+void UniformRing::Upload()
+{
+	if (mStaging.empty())
+	{
+		return;
+	}
+
+	gRenderBackend->BindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+	// The last window is bound whole even if it isn't full, so it needs room
+	// past the end
+	const size_t NEEDED = mStaging.size() + mBindSize;
+	if (mHead + NEEDED > mCapacity)
+	{
+		// Orphan it: the driver keeps the old storage until the GPU is done with it
+		mCapacity = std::max(mCapacity, NEEDED);
+		gRenderBackend->BufferData(GL_UNIFORM_BUFFER, mCapacity, nullptr, GL_STREAM_DRAW);
+		mHead = 0;
+	}
+	gRenderBackend->BufferSubData(GL_UNIFORM_BUFFER, mHead, mStaging.size(), mStaging.data());
+
+	mUploadOffset = mHead;
+	mHead = (mHead + mStaging.size() + mAlignment - 1) / mAlignment * mAlignment;
+	mStaging.clear();
+	mBoundWindow = -1;
+}
+
+int UniformRing::Bind(int index) const
+{
+	const int WINDOW = index / static_cast<int>(mBlocksPerBind);
+	const int FIRST = WINDOW * static_cast<int>(mBlocksPerBind);
+	if (WINDOW != mBoundWindow)
+	{
+		gRenderBackend->BindBufferRange(GL_UNIFORM_BUFFER, mBinding, mBuffer,
+										mUploadOffset + static_cast<size_t>(FIRST) * mStride,
+										mBindSize);
+		mBoundWindow = WINDOW;
+	}
+	return index - FIRST;
+}
+
+void UniformRing::Push(const void* data)
+{
+	int index = Add(data);
+	Upload();
+	Bind(index);
+}
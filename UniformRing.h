@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Streams small uniform blocks (per pass or per draw data) through one
+// buffer. Blocks are added on the CPU, uploaded together, then bound to a
+// uniform block binding point. Uploads go one after another through the
+// buffer; once it's full it's orphaned and filling starts over from the
+// beginning, so nothing the GPU hasn't used yet gets overwritten.
+//
+// With blocksPerBind > 1 the shader's block is an array of blocksPerBind
+// elements instead, and a bind covers that many blocks at once (a window).
+// Draws index the array, so binding only happens when a draw's block is in
+// a different window than the last one.
+class UniformRing
+{
+public:
+	// blockSize is the size of the std140 block in the shaders, or of one
+	// array element (a multiple of 16) if blocksPerBind > 1. blocksPerBind
+	// elements must fill a multiple of the offset alignment.
+	UniformRing(unsigned int binding, size_t blockSize, size_t blocksPerBind = 1);
+	~UniformRing();
+
+	// Stages a block (blockSize bytes), returning its index for Bind after
+	// the next Upload
+	int Add(const void* data);
+	// Sends every block staged since the last Upload
+	void Upload();
+	// Makes sure the window with this block is bound, returning where the
+	// block is in it (always 0 if blocksPerBind is 1)
+	int Bind(int index) const;
+
+	// Add, Upload and Bind for a single block
+	void Push(const void* data);
+
+private:
+	static constexpr size_t INITIAL_CAPACITY = 256 * 1024;
+
+	unsigned int mBuffer = 0;
+	unsigned int mBinding;
+	size_t mBlockSize;
+	size_t mBlocksPerBind;
+	// Offset alignment GL needs for binding
+	size_t mAlignment = 0;
+	// Between blocks: the block size, rounded up to the alignment if each
+	// one is bound on its own
+	size_t mStride = 0;
+	// How much one bind covers
+	size_t mBindSize = 0;
+	// Window last bound since the last Upload, -1 if none
+	mutable int mBoundWindow = -1;
+
+	size_t mCapacity = INITIAL_CAPACITY;
+	// Where the next upload goes, and where the last one went
+	size_t mHead = 0;
+	size_t mUploadOffset = 0;
+	std::vector<unsigned char> mStaging;
+};
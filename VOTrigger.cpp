@@ -14,7 +14,23 @@ VOTrigger::VOTrigger()
 {
 	mCollision = CreateComponent<CollisionComponent>();
 	mCollision->SetSize({1.0f, 1.0f, 1.0f});
+	mCollision->SetLayer(CollisionLayer::Trigger);
 	mCurrentSoundHandle = SoundHandle::Invalid;
+
+	// Activates on the first frame a living player is inside
+	auto onPlayerInside = [this](CollisionComponent* other) {
+		if (!mIsActivated && other->GetLayer() == CollisionLayer::Player)
+		{
+			HealthComponent* playerHealth = other->GetOwner()->GetComponent<HealthComponent>();
+			if (!playerHealth || !playerHealth->IsDead())
+			{
+				mIsActivated = true;
+				PlayNextSound();
+			}
+		}
+	};
+	mCollision->SetOnTriggerEnter(onPlayerInside);
+	mCollision->SetOnTriggerStay(onPlayerInside);
 }
 
 VOTrigger::~VOTrigger() = default;
@@ -30,19 +46,8 @@ void VOTrigger::HandleUpdate(float /*deltaTime*/)
 
 	bool playerIsDead = playerHealth && playerHealth->IsDead();
 
-	if (!mIsActivated)
-	{
-		if (player && !playerIsDead)
-		{
-			CollisionComponent* playerColl = player->GetComponent<CollisionComponent>();
-			if (playerColl && mCollision->Intersect(playerColl))
-			{
-				mIsActivated = true;
-				PlayNextSound();
-			}
-		}
-	}
-	else
+	// Activation comes from the trigger events
+	if (mIsActivated)
 	{
 		if (playerIsDead)
 		{
@@ -1,5 +1,6 @@
 #include "VertexArray.h"
-#include <GL/glew.h>
+#include "GLState.h"
+#include "RenderBackend.h"
 
 VertexArray::VertexArray(const float* verts, unsigned int numVerts, const unsigned int* indices,
 						 unsigned int numIndices)
@@ -10,45 +11,45 @@ VertexArray::VertexArray(const float* verts, unsigned int numVerts, const unsign
 , mVertexArray(0)
 {
 	// Create vertex array
-	glGenVertexArrays(1, &mVertexArray);
-	glBindVertexArray(mVertexArray);
+	mVertexArray = gRenderBackend->CreateVertexArray();
+	gGLState.BindVertexArray(mVertexArray);
 
 	// Create vertex buffer
-	glGenBuffers(1, &mVertexBuffer);
-	glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-	glBufferData(GL_ARRAY_BUFFER, static_cast<long>(numVerts * 8 * sizeof(float)), verts,
-				 GL_STATIC_DRAW);
+	mVertexBuffer = gRenderBackend->CreateBuffer();
+	gRenderBackend->BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+	gRenderBackend->BufferData(GL_ARRAY_BUFFER, numVerts * 8 * sizeof(float), verts,
+							   GL_STATIC_DRAW);
 
 	// Create index buffer
-	glGenBuffers(1, &mIndexBuffer);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<long>(numIndices * sizeof(GLuint)), indices,
-				 GL_STATIC_DRAW);
+	mIndexBuffer = gRenderBackend->CreateBuffer();
+	gRenderBackend->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+	gRenderBackend->BufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(GLuint), indices,
+							   GL_STATIC_DRAW);
 
+	SetVertexAttributes();
+}
+
+VertexArray::~VertexArray()
+{
+	gRenderBackend->DeleteBuffer(mVertexBuffer);
+	gRenderBackend->DeleteBuffer(mIndexBuffer);
+	gRenderBackend->DeleteVertexArray(mVertexArray);
+	gGLState.OnVertexArrayDeleted(mVertexArray);
+}
+
+void VertexArray::SetVertexAttributes()
+{
 	// Specify the vertex attributes
 	// (For now, assume one vertex format)
 	// Position is 3 floats
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), nullptr);
+	gRenderBackend->EnableVertexAttribute(0, 3, 8 * sizeof(float), 0);
 	// Normal is 3 floats
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float),
-						  reinterpret_cast<void*>(sizeof(float) * 3));
+	gRenderBackend->EnableVertexAttribute(1, 3, 8 * sizeof(float), sizeof(float) * 3);
 	// Texture coordinates is 2 floats
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float),
-						  reinterpret_cast<void*>(sizeof(float) * 6));
-}
-
-VertexArray::~VertexArray()
-{
-	glDeleteBuffers(1, &mVertexBuffer);
-	glDeleteBuffers(1, &mIndexBuffer);
-	glDeleteVertexArrays(1, &mVertexArray);
+	gRenderBackend->EnableVertexAttribute(2, 2, 8 * sizeof(float), sizeof(float) * 6);
 }
 
 void VertexArray::SetActive() const
 {
-	glBindVertexArray(mVertexArray);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+	gGLState.BindVertexArray(mVertexArray);
 }
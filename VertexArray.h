@@ -7,6 +7,8 @@ public:
 	~VertexArray();
 
 	void SetActive() const;
+	// Points attributes 0-2 (position, normal, tex coords) at the bound vertex buffer
+	static void SetVertexAttributes();
 	unsigned int GetNumIndices() const { return mNumIndices; }
 	unsigned int GetNumVerts() const { return mNumVerts; }
 